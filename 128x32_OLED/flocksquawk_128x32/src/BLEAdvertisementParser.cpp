@@ -0,0 +1,122 @@
+#include "BLEAdvertisementParser.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// Bluetooth Base UUID 00000000-0000-1000-8000-00805f9b34fb, little-endian.
+static const uint8_t BASE_UUID_LE[16] = {
+    0xfb, 0x34, 0x9b, 0x5f, 0x80, 0x00, 0x00, 0x80,
+    0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+};
+
+void BLEAdvertisementParser::addUuid16(AdvertisementView& view, uint16_t uuid) {
+    for (uint8_t i = 0; i < view.uuid16Count; i++) {
+        if (view.uuid16[i] == uuid) return;
+    }
+    if (view.uuid16Count < AdvertisementView::MAX_UUID16) {
+        view.uuid16[view.uuid16Count++] = uuid;
+    } else {
+        view.truncated = true;
+    }
+}
+
+bool BLEAdvertisementParser::parse(const uint8_t* payload, size_t length, AdvertisementView& view) {
+    memset(&view, 0, sizeof(view));
+    if (!payload || length == 0) return false;
+
+    const uint8_t* cursor = payload;
+    const uint8_t* end = payload + length;
+
+    while (end - cursor >= 1) {
+        uint8_t len = cursor[0];
+        if (len == 0) {
+            // Zero-length structure marks the start of padding.
+            break;
+        }
+        if (len > end - cursor - 1) {
+            view.truncated = true;
+            break;
+        }
+
+        uint8_t type = cursor[1];
+        const uint8_t* body = cursor + 2;
+        uint8_t bodyLength = len - 1;
+        view.structureCount++;
+
+        switch (type) {
+            case AD_FLAGS:
+                if (bodyLength >= 1) view.flags = body[0];
+                break;
+            case AD_UUID16_INCOMPLETE:
+            case AD_UUID16_COMPLETE:
+                for (uint8_t i = 0; i + 1 < bodyLength; i += 2) {
+                    addUuid16(view, body[i] | (body[i + 1] << 8));
+                }
+                break;
+            case AD_UUID128_INCOMPLETE:
+            case AD_UUID128_COMPLETE:
+                for (uint8_t i = 0; i + 16 <= bodyLength; i += 16) {
+                    const uint8_t* uuid = body + i;
+                    // A 128-bit UUID on the base is really a 16-bit one.
+                    if (memcmp(uuid, BASE_UUID_LE, 12) == 0 && uuid[14] == 0 && uuid[15] == 0) {
+                        addUuid16(view, uuid[12] | (uuid[13] << 8));
+                    } else if (view.uuid128Count < AdvertisementView::MAX_UUID128) {
+                        view.uuid128[view.uuid128Count++] = uuid;
+                    } else {
+                        view.truncated = true;
+                    }
+                }
+                break;
+            case AD_NAME_SHORT:
+            case AD_NAME_COMPLETE:
+                // Prefer the complete name when both are present.
+                if (!view.name || type == AD_NAME_COMPLETE) {
+                    view.name = body;
+                    view.nameLength = bodyLength;
+                }
+                break;
+            case AD_TX_POWER:
+                if (bodyLength >= 1) {
+                    view.hasTxPower = true;
+                    view.txPower = (int8_t)body[0];
+                }
+                break;
+            case AD_SERVICE_DATA16:
+                if (bodyLength >= 2) {
+                    addUuid16(view, body[0] | (body[1] << 8));
+                }
+                break;
+            case AD_MANUFACTURER_DATA:
+                if (bodyLength >= 2 && !view.hasManufacturerData) {
+                    view.hasManufacturerData = true;
+                    view.manufacturerId = body[0] | (body[1] << 8);
+                    view.manufacturerData = body + 2;
+                    view.manufacturerDataLength = bodyLength - 2;
+                }
+                break;
+            default:
+                break;
+        }
+
+        cursor = body + bodyLength;
+    }
+
+    return true;
+}
+
+void BLEAdvertisementParser::formatUuid16(uint16_t uuid, char* out) {
+    snprintf(out, UUID_STRING_LENGTH + 1, "0000%04x-0000-1000-8000-00805f9b34fb", uuid);
+}
+
+void BLEAdvertisementParser::formatUuid128(const uint8_t* uuidLE, char* out) {
+    static const char hex[] = "0123456789abcdef";
+    size_t pos = 0;
+    for (int i = 15; i >= 0; i--) {
+        out[pos++] = hex[uuidLE[i] >> 4];
+        out[pos++] = hex[uuidLE[i] & 0x0F];
+        if (i == 12 || i == 10 || i == 8 || i == 6) {
+            out[pos++] = '-';
+        }
+    }
+    out[pos] = '\0';
+}
@@ -0,0 +1,61 @@
+#ifndef BLE_ADVERTISEMENT_PARSER_H
+#define BLE_ADVERTISEMENT_PARSER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Read-only view over a raw advertisement (AD structures, with any scan
+// response appended). Pointers alias the payload passed to
+// BLEAdvertisementParser::parse() and are only valid while it is.
+struct AdvertisementView {
+    static const uint8_t MAX_UUID16 = 8;
+    static const uint8_t MAX_UUID128 = 2;
+
+    uint8_t flags;
+    const uint8_t* name;              // Complete or shortened local name, not NUL-terminated
+    uint8_t nameLength;
+    bool hasTxPower;
+    int8_t txPower;                   // dBm
+
+    uint16_t uuid16[MAX_UUID16];      // Service UUIDs and service-data UUIDs, deduplicated
+    uint8_t uuid16Count;
+    const uint8_t* uuid128[MAX_UUID128];  // 16 bytes each, little-endian as on air
+    uint8_t uuid128Count;
+
+    bool hasManufacturerData;
+    uint16_t manufacturerId;
+    const uint8_t* manufacturerData;  // Bytes after the company identifier
+    uint8_t manufacturerDataLength;
+
+    uint8_t structureCount;
+    bool truncated;                   // A structure ran past the end, or UUIDs didn't fit
+};
+
+class BLEAdvertisementParser {
+public:
+    static const uint8_t AD_FLAGS = 0x01;
+    static const uint8_t AD_UUID16_INCOMPLETE = 0x02;
+    static const uint8_t AD_UUID16_COMPLETE = 0x03;
+    static const uint8_t AD_UUID128_INCOMPLETE = 0x06;
+    static const uint8_t AD_UUID128_COMPLETE = 0x07;
+    static const uint8_t AD_NAME_SHORT = 0x08;
+    static const uint8_t AD_NAME_COMPLETE = 0x09;
+    static const uint8_t AD_TX_POWER = 0x0A;
+    static const uint8_t AD_SERVICE_DATA16 = 0x16;
+    static const uint8_t AD_MANUFACTURER_DATA = 0xFF;
+
+    static const size_t UUID_STRING_LENGTH = 36;
+
+    // Walks every AD structure. Returns false only for a null/empty payload.
+    static bool parse(const uint8_t* payload, size_t length, AdvertisementView& view);
+
+    // Canonical lowercase form, e.g. "0000180a-0000-1000-8000-00805f9b34fb".
+    // `out` must hold UUID_STRING_LENGTH + 1 bytes.
+    static void formatUuid16(uint16_t uuid, char* out);
+    static void formatUuid128(const uint8_t* uuidLE, char* out);
+
+private:
+    static void addUuid16(AdvertisementView& view, uint16_t uuid);
+};
+
+#endif
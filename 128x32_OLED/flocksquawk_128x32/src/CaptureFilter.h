@@ -0,0 +1,44 @@
+#ifndef CAPTURE_FILTER_H
+#define CAPTURE_FILTER_H
+
+#include <Arduino.h>
+#include "esp_wifi.h"
+#include "esp_wifi_types.h"
+
+// Two-stage WiFi capture filter. Stage one asks the driver to deliver only
+// management frames, so data and control traffic never wakes the promiscuous
+// callback. Stage two runs first thing in the callback and rejects any
+// management subtype we do not analyze before the frame is parsed.
+class CaptureFilter {
+public:
+    static const uint8_t MAX_CHANNEL = 14;
+
+    struct ChannelCounters {
+        uint32_t accepted;
+        uint32_t rejected;
+    };
+
+    // Bit N set = management subtype N is accepted. These are the only
+    // subtypes WiFiFrameParser handles, so setSubtypeMask() can narrow the
+    // default but not widen it: other bits are ignored.
+    static const uint16_t DEFAULT_SUBTYPE_MASK = (1 << 0x04) | (1 << 0x05) | (1 << 0x08);
+
+    static void applyDriverFilter();
+    static void setSubtypeMask(uint16_t mask);
+    static uint16_t getSubtypeMask();
+
+    // Called from the promiscuous callback. `length` is rx_ctrl.sig_len.
+    static bool accept(wifi_promiscuous_pkt_type_t type, const uint8_t* frame,
+                       size_t length, uint8_t channel);
+
+    static ChannelCounters getChannelCounters(uint8_t channel);
+    static ChannelCounters getTotalCounters();
+    static void resetCounters();
+
+private:
+    static volatile uint16_t subtypeMask;
+    static uint32_t acceptedFrames[MAX_CHANNEL + 1];
+    static uint32_t rejectedFrames[MAX_CHANNEL + 1];
+};
+
+#endif
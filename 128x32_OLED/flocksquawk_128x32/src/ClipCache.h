@@ -0,0 +1,77 @@
+#ifndef CLIP_CACHE_H
+#define CLIP_CACHE_H
+
+#include <Arduino.h>
+#include <FS.h>
+
+struct ClipCacheStats {
+    uint32_t hits;
+    uint32_t misses;            // Clip had to be read from the filesystem
+    uint32_t evictions;
+    uint32_t rejected;          // Too large for the budget, or out of memory
+};
+
+// Whole WAV files held in RAM, so playing a sound is a memory read instead
+// of a filesystem open, seek and read, and the heap sees one allocation per
+// clip instead of one per play. Clips preloaded at boot are pinned for the
+// life of the program; any other clip is loaded on first play and kept
+// while the budget allows, evicting the least recently played unpinned
+// clip to make room.
+//
+// Clips live in PSRAM only. Without it the cache stays empty and the caller
+// streams from the filesystem as before: even one clip would pin 75 KB or
+// more of the internal heap that the WiFi and NimBLE stacks, I2S DMA and
+// the pipeline queues need.
+//
+// A clip returned by get() stays valid until the next get() after that:
+// eviction never takes a pinned clip or the one handed out last, so a
+// caller can start a new sound while the previous one drains. Not
+// thread-safe; the task that plays sounds owns it.
+class ClipCache {
+public:
+    static const uint8_t MAX_CLIPS = 8;
+    static const size_t MAX_PATH = 32;
+    static const size_t PSRAM_BUDGET = 1024 * 1024;
+
+    struct Clip {
+        const uint8_t* data;
+        size_t length;
+    };
+
+    ClipCache();
+
+    // False when the board has no PSRAM; get() and preload() then fail.
+    bool begin(fs::FS& filesystem);
+    bool preload(const char* path);
+    bool get(const char* path, Clip& clip);
+
+    uint8_t count() const;
+    size_t bytesUsed() const { return usedBytes; }
+    size_t budget() const { return budgetBytes; }
+    bool enabled() const { return budgetBytes > 0; }
+    const ClipCacheStats& getStats() const { return stats; }
+
+private:
+    struct Entry {
+        char path[MAX_PATH];
+        uint8_t* data;          // nullptr = free slot
+        size_t length;
+        uint32_t lastUsed;
+        bool pinned;
+    };
+
+    fs::FS* filesystem;
+    Entry entries[MAX_CLIPS];
+    size_t budgetBytes;
+    size_t usedBytes;
+    uint32_t useCounter;
+    int8_t lastHandedOut;
+    ClipCacheStats stats;
+
+    int8_t find(const char* path) const;
+    int8_t load(const char* path, bool pinned);
+    bool makeRoom(size_t length);
+    void evict(Entry& entry);
+};
+
+#endif
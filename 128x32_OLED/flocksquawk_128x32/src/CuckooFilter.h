@@ -0,0 +1,72 @@
+#ifndef CUCKOO_FILTER_H
+#define CUCKOO_FILTER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Approximate set of MAC addresses with insert and delete. Each bucket holds
+// SLOTS 16-bit fingerprints; an address can live in one of two buckets, and
+// inserts relocate existing fingerprints to make room. With four slots per
+// bucket the false-positive rate is about 8 / 65536 (0.012%) at any load,
+// and the table stays insertable up to roughly 95% full.
+//
+// Storage is provided by the caller, so the memory budget is fixed at
+// compile time: 2 * SLOTS bytes per bucket. Inserting an address twice
+// stores it twice, and deleting an address that was never inserted may
+// delete a colliding one, so only remove what was added.
+//
+// Not thread-safe. Inserts come in two steps so a shared table can stay
+// readable during the eviction walk: planInsert() only reads the table, and
+// commitInsert() is a short run of slot writes the caller can guard with
+// the same lock as its lookups.
+class CuckooFilter {
+public:
+    static const uint8_t SLOTS = 4;
+    static const uint16_t MAX_KICKS = 500;
+    static const uint16_t MAX_MOVES = MAX_KICKS + 1;
+
+    // One slot write of a planned insert
+    struct Move {
+        uint16_t index;
+        uint8_t slot;
+        uint16_t fingerprint;
+    };
+
+    // `buckets` must hold bucketCount * SLOTS entries; bucketCount is a
+    // power of two, at most 65536. The filter starts empty.
+    CuckooFilter(uint16_t* buckets, size_t bucketCount);
+
+    // Writes the slot moves that place `mac` into `moves`, which must have
+    // room for MAX_MOVES, and returns how many; 0 when the filter is full.
+    // commitInsert() must follow before anything else changes the filter.
+    size_t planInsert(const uint8_t* mac, Move* moves);
+    void commitInsert(const Move* moves, size_t moveCount);
+    bool remove(const uint8_t* mac);
+    bool contains(const uint8_t* mac) const;
+    void clear();
+
+    size_t size() const { return count; }
+    size_t capacity() const { return bucketCount * SLOTS; }
+
+    // Raw table for persistence. restore() takes a table previously taken
+    // from a filter of the same size and returns false on a size mismatch.
+    const uint16_t* getBuckets() const { return buckets; }
+    size_t getBucketCount() const { return bucketCount; }
+    bool restore(const uint16_t* table, size_t tableBucketCount);
+
+private:
+    uint16_t* buckets;
+    size_t bucketCount;
+    size_t count;
+    uint32_t kickState;
+
+    static uint32_t hashMac(const uint8_t* mac);
+    static uint16_t fingerprintOf(uint32_t hash);
+    size_t altIndex(size_t index, uint16_t fingerprint) const;
+    bool bucketContains(size_t index, uint16_t fingerprint) const;
+    int8_t freeSlot(size_t index) const;
+    uint16_t plannedSlot(const Move* moves, size_t moveCount, size_t index, uint8_t slot) const;
+    bool bucketRemove(size_t index, uint16_t fingerprint);
+};
+
+#endif
@@ -0,0 +1,83 @@
+#include "TaskTopology.h"
+
+#include "esp_timer.h"
+
+TaskTopology::TaskConfig TaskTopology::configs[TaskTopology::TASK_COUNT] = {
+    { "analysis",  6144, 3, TaskTopology::PIPELINE_CORE },
+    { "dispatch",  6144, 2, TaskTopology::PIPELINE_CORE },
+    { "telemetry", 6144, 2, TaskTopology::PIPELINE_CORE },
+    { "audio",     4096, 2, TaskTopology::PIPELINE_CORE },
+    { "render",    0,    1, TaskTopology::PIPELINE_CORE },  // loopTask; stack set by the core
+};
+TaskHandle_t TaskTopology::handles[TaskTopology::TASK_COUNT] = {};
+int64_t TaskTopology::workStartUs[TaskTopology::TASK_COUNT] = {};
+uint64_t TaskTopology::busyUs[TaskTopology::TASK_COUNT] = {};
+uint32_t TaskTopology::workItems[TaskTopology::TASK_COUNT] = {};
+int64_t TaskTopology::statsSinceUs = 0;
+portMUX_TYPE TaskTopology::statsMux = portMUX_INITIALIZER_UNLOCKED;
+
+BaseType_t TaskTopology::resolveCore(BaseType_t core) {
+    return core < portNUM_PROCESSORS ? core : portNUM_PROCESSORS - 1;
+}
+
+TaskTopology::TaskConfig& TaskTopology::config(TaskId id) {
+    return configs[id];
+}
+
+bool TaskTopology::start(TaskId id, TaskFunction_t entry, void* param) {
+    const TaskConfig& cfg = configs[id];
+    BaseType_t result = xTaskCreatePinnedToCore(entry, cfg.name, cfg.stackSize, param,
+                                                cfg.priority, &handles[id],
+                                                resolveCore(cfg.core));
+    return result == pdPASS;
+}
+
+void TaskTopology::adoptCurrentTask(TaskId id) {
+    handles[id] = xTaskGetCurrentTaskHandle();
+    configs[id].core = xPortGetCoreID();
+    vTaskPrioritySet(nullptr, configs[id].priority);
+}
+
+TaskHandle_t TaskTopology::handle(TaskId id) {
+    return handles[id];
+}
+
+void TaskTopology::beginWork(TaskId id) {
+    workStartUs[id] = esp_timer_get_time();
+}
+
+void TaskTopology::endWork(TaskId id) {
+    int64_t elapsed = esp_timer_get_time() - workStartUs[id];
+    portENTER_CRITICAL(&statsMux);
+    busyUs[id] += elapsed;
+    workItems[id]++;
+    portEXIT_CRITICAL(&statsMux);
+}
+
+TaskTopology::TaskStats TaskTopology::getStats(TaskId id) {
+    TaskStats stats;
+    stats.name = configs[id].name;
+    stats.core = resolveCore(configs[id].core);
+    stats.priority = configs[id].priority;
+
+    portENTER_CRITICAL(&statsMux);
+    stats.busyUs = busyUs[id];
+    stats.workItems = workItems[id];
+    portEXIT_CRITICAL(&statsMux);
+
+    int64_t window = esp_timer_get_time() - statsSinceUs;
+    stats.loadPercent = window > 0 ? (uint8_t)(stats.busyUs * 100 / window) : 0;
+    // The ESP-IDF port reports stack in bytes.
+    stats.stackFree = handles[id] ? uxTaskGetStackHighWaterMark(handles[id]) : 0;
+    return stats;
+}
+
+void TaskTopology::resetStats() {
+    portENTER_CRITICAL(&statsMux);
+    for (uint8_t i = 0; i < TASK_COUNT; i++) {
+        busyUs[i] = 0;
+        workItems[i] = 0;
+    }
+    statsSinceUs = esp_timer_get_time();
+    portEXIT_CRITICAL(&statsMux);
+}
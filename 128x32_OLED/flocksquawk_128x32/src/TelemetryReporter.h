@@ -8,7 +8,7 @@
 class TelemetryReporter {
 public:
     void initialize();
-    void handleThreatDetection(const ThreatEvent& threat);
+    void handleDevicePresence(const DevicePresenceEvent& event);
     
 private:
     unsigned long bootTime;
@@ -18,6 +18,7 @@ private:
     void appendTargetIdentity(const ThreatEvent& threat, JsonDocument& doc);
     void appendIndicators(const ThreatEvent& threat, JsonDocument& doc);
     void appendMetadata(const ThreatEvent& threat, JsonDocument& doc);
+    void appendPresence(const DevicePresenceEvent& event, JsonDocument& doc);
     void outputJSON(const JsonDocument& doc);
 };
 
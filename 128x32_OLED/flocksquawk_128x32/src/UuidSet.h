@@ -0,0 +1,89 @@
+#ifndef UUID_SET_H
+#define UUID_SET_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// 128-bit UUID, little-endian as it appears on air.
+struct Uuid128 {
+    uint8_t bytes[16];
+
+    // 0000xxxx-0000-1000-8000-00805f9b34fb for a Bluetooth SIG short form.
+    static constexpr Uuid128 fromShort(uint16_t uuid) {
+        return Uuid128{{0xfb, 0x34, 0x9b, 0x5f, 0x80, 0x00, 0x00, 0x80,
+                        0x00, 0x10, 0x00, 0x00,
+                        (uint8_t)(uuid & 0xFF), (uint8_t)(uuid >> 8), 0x00, 0x00}};
+    }
+
+    // Canonical text form, e.g. "0000180a-0000-1000-8000-00805f9b34fb",
+    // either case. Usable in constant expressions, so signature lists stay
+    // readable while compiling down to bytes.
+    static constexpr Uuid128 parse(const char* text) {
+        return Uuid128{{hexByte(text, 34), hexByte(text, 32), hexByte(text, 30), hexByte(text, 28),
+                        hexByte(text, 26), hexByte(text, 24), hexByte(text, 21), hexByte(text, 19),
+                        hexByte(text, 16), hexByte(text, 14), hexByte(text, 11), hexByte(text, 9),
+                        hexByte(text, 6), hexByte(text, 4), hexByte(text, 2), hexByte(text, 0)}};
+    }
+
+    static constexpr uint8_t hexNibble(char c) {
+        return (uint8_t)((c >= '0' && c <= '9') ? c - '0' :
+                         (c >= 'a' && c <= 'f') ? c - 'a' + 10 :
+                         (c >= 'A' && c <= 'F') ? c - 'A' + 10 : 0);
+    }
+
+    static constexpr uint8_t hexByte(const char* text, size_t offset) {
+        return (uint8_t)((hexNibble(text[offset]) << 4) | hexNibble(text[offset + 1]));
+    }
+};
+
+// Open-addressed hash layout over a list of UUIDs. Entries derived from the
+// Bluetooth Base UUID are indexed by their 16-bit alias, everything else by a
+// hash of all 128 bits. Slots hold entry index + 1, with 0 marking an empty
+// slot. Plain pointers, so the same layout can be built in RAM or read in
+// place from a signature file.
+struct UuidSetTable {
+    uint16_t entryCount;
+    uint16_t slotMask;                // Slot count - 1; slot count is a power of two
+    const Uuid128* entries;           // [entryCount]
+    const uint16_t* aliasSlots;       // [slotMask + 1] base UUIDs, keyed by 16-bit alias
+    const uint16_t* fullSlots;        // [slotMask + 1] other UUIDs, keyed by full value
+};
+
+class UuidSet {
+public:
+    static const int NOT_FOUND = -1;
+
+    UuidSet() : table() {}
+    explicit UuidSet(const UuidSetTable& table) : table(table) {}
+
+    static bool isBaseUuid(const uint8_t* uuid);
+    static uint16_t shortAlias(const uint8_t* uuid) { return (uint16_t)(uuid[12] | (uuid[13] << 8)); }
+
+    // Indexes `uuids` into `buffer` (requiredBytes(count) bytes, 2-byte
+    // aligned). The entries themselves are referenced, not copied, and must
+    // outlive the set. Returns false if the buffer is too small or there are
+    // 32768 or more entries.
+    static size_t requiredBytes(size_t count);
+    static bool build(const Uuid128* uuids, size_t count,
+                      void* buffer, size_t bufferSize, UuidSetTable& out);
+
+    // Each lookup returns the index of the matching entry, or NOT_FOUND.
+    int find(uint16_t uuid16) const;
+    int find(const uint8_t* uuid128) const;
+
+    // Checks every advertised UUID in one call and returns the first match.
+    int findAny(const uint16_t* uuid16, size_t uuid16Count,
+                const uint8_t (*uuid128)[16], size_t uuid128Count) const;
+
+    bool isReady() const { return table.entryCount > 0; }
+    size_t size() const { return table.entryCount; }
+    const UuidSetTable& getTable() const { return table; }
+
+private:
+    UuidSetTable table;
+
+    static uint16_t hash16(uint16_t uuid);
+    static uint32_t hash128(const uint8_t* uuid);
+};
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef VOLUME_KERNEL_H
+#define VOLUME_KERNEL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Gain for 16-bit PCM in Q15 fixed point, where UNITY_Q15 is 1.0: one
+// integer multiply, add and shift per sample. The float loop it replaced
+// also converted every sample to float and back and clamped it; the ESP32's
+// FPU does the multiply quickly, but those conversions and the clamp are
+// per-sample work this path does not have.
+//
+// Gains are 0..UNITY_Q15, so a result is never larger in magnitude than its
+// input and needs no saturation. Results round to nearest, so they can
+// differ from the old truncating float loop by one LSB. At unity gain the
+// output equals the input, which lets callers skip the pass entirely.
+//
+// ramp() moves the gain toward a new target by a fixed step per sample
+// pair, so a volume change fades over a few milliseconds instead of
+// jumping mid-waveform and clicking. Header-only, like BatchMatcher, so the
+// host benchmark builds the same code.
+namespace VolumeKernel {
+
+static const int32_t UNITY_Q15 = 32768;
+
+inline int32_t toQ15(float level) {
+    if (level <= 0.0f) return 0;
+    if (level >= 1.0f) return UNITY_Q15;
+    return (int32_t)(level * UNITY_Q15 + 0.5f);
+}
+
+// gainQ15 is 0..UNITY_Q15.
+inline int16_t scaleSample(int16_t sample, int32_t gainQ15) {
+    return (int16_t)((sample * gainQ15 + (1 << 14)) >> 15);
+}
+
+inline void scale(int16_t* samples, size_t count, int32_t gainQ15) {
+    for (size_t i = 0; i < count; i++) {
+        samples[i] = scaleSample(samples[i], gainQ15);
+    }
+}
+
+// Scales with a gain that starts at fromQ15 and moves stepQ15 toward toQ15
+// every sample pair; once there, the rest is scaled at toQ15. A step of 0
+// jumps straight to the target. Returns the gain reached, which the caller
+// passes back as fromQ15 for the next buffer.
+inline int32_t ramp(int16_t* samples, size_t count, int32_t fromQ15, int32_t toQ15, int32_t stepQ15) {
+    int32_t gain = stepQ15 > 0 ? fromQ15 : toQ15;
+    size_t i = 0;
+    while (gain != toQ15 && i < count) {
+        if (gain < toQ15) gain = (toQ15 - gain > stepQ15) ? gain + stepQ15 : toQ15;
+        else gain = (gain - toQ15 > stepQ15) ? gain - stepQ15 : toQ15;
+        size_t n = count - i < 2 ? count - i : 2;
+        for (size_t j = 0; j < n; j++) samples[i + j] = scaleSample(samples[i + j], gain);
+        i += n;
+    }
+    if (i < count) scale(samples + i, count - i, toQ15);
+    return gain;
+}
+
+}  // namespace VolumeKernel
+
+#endif
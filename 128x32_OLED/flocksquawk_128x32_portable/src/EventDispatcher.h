@@ -0,0 +1,146 @@
+#ifndef EVENT_DISPATCHER_H
+#define EVENT_DISPATCHER_H
+
+#include <Arduino.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "esp_timer.h"
+
+// Bounded queues, one per priority, between any number of publishers and a
+// single dispatcher task. post() copies an item into its priority's queue
+// without blocking, from a task or an ISR; a full queue drops the item and
+// counts it. take() hands the dispatcher one item at a time from the most
+// urgent non-empty queue, so an urgent item waits behind at most the one
+// being delivered. A counting semaphore carries one token per queued item,
+// which lets the dispatcher sleep on all queues at once.
+//
+// Item is copied by value and must have a `uint32_t postedUs` member, which
+// post() stamps for the latency counters. Queues are created once by begin()
+// and never freed.
+template <typename Item>
+class EventDispatcher {
+public:
+    enum Priority : uint8_t {
+        URGENT = 0,
+        NORMAL,
+        BACKGROUND,
+        PRIORITY_COUNT
+    };
+
+    struct QueueStats {
+        uint16_t depth;             // Items waiting now
+        uint16_t capacity;
+        uint16_t highWater;
+        uint32_t posted;
+        uint32_t dropped;           // Queue full, or posted before begin()
+        uint32_t delivered;
+        uint32_t meanLatencyUs;     // Post to take, over `delivered`
+        uint32_t maxLatencyUs;
+    };
+
+    EventDispatcher() : pending(nullptr), queues(), capacities() {}
+
+    bool begin(const uint16_t depths[PRIORITY_COUNT]) {
+        if (pending) return true;
+        UBaseType_t total = 0;
+        for (uint8_t p = 0; p < PRIORITY_COUNT; p++) {
+            queues[p] = xQueueCreate(depths[p], sizeof(Item));
+            if (!queues[p]) return false;
+            capacities[p] = depths[p];
+            total += depths[p];
+        }
+        pending = xSemaphoreCreateCounting(total, 0);
+        return pending != nullptr;
+    }
+
+    bool isRunning() const { return pending != nullptr; }
+
+    // Any context. Returns false (and counts the drop) if the item was not queued.
+    bool post(Priority priority, Item& item) {
+        item.postedUs = (uint32_t)esp_timer_get_time();
+        bool queued = false;
+        if (pending) {
+            if (xPortInIsrContext()) {
+                BaseType_t woken = pdFALSE;
+                queued = xQueueSendFromISR(queues[priority], &item, &woken) == pdTRUE;
+                if (queued) xSemaphoreGiveFromISR(pending, &woken);
+                if (woken) portYIELD_FROM_ISR();
+            } else {
+                queued = xQueueSend(queues[priority], &item, 0) == pdTRUE;
+                if (queued) xSemaphoreGive(pending);
+            }
+        }
+        portENTER_CRITICAL_SAFE(&statsMux);
+        if (queued) counters[priority].posted++;
+        else counters[priority].dropped++;
+        portEXIT_CRITICAL_SAFE(&statsMux);
+        return queued;
+    }
+
+    // Dispatcher task only. Waits up to `wait` ticks for an item.
+    bool take(Item& item, Priority& priority, TickType_t wait) {
+        if (!pending || xSemaphoreTake(pending, wait) != pdTRUE) return false;
+        // Every token was given after its item was queued, so some queue
+        // holds at least one item here.
+        for (uint8_t p = 0; p < PRIORITY_COUNT; p++) {
+            UBaseType_t waiting = uxQueueMessagesWaiting(queues[p]);
+            if (waiting == 0 || xQueueReceive(queues[p], &item, 0) != pdTRUE) continue;
+            uint32_t latencyUs = (uint32_t)esp_timer_get_time() - item.postedUs;
+            portENTER_CRITICAL(&statsMux);
+            Counters& c = counters[p];
+            // Depth only falls when an item is taken, so its peak is always
+            // seen here.
+            if (waiting > c.highWater) c.highWater = (uint16_t)waiting;
+            c.delivered++;
+            c.latencyTotalUs += latencyUs;
+            if (latencyUs > c.maxLatencyUs) c.maxLatencyUs = latencyUs;
+            portEXIT_CRITICAL(&statsMux);
+            priority = (Priority)p;
+            return true;
+        }
+        return false;
+    }
+
+    QueueStats getStats(Priority priority) {
+        QueueStats stats;
+        portENTER_CRITICAL(&statsMux);
+        const Counters& c = counters[priority];
+        stats.highWater = c.highWater;
+        stats.posted = c.posted;
+        stats.dropped = c.dropped;
+        stats.delivered = c.delivered;
+        stats.meanLatencyUs = c.delivered ? (uint32_t)(c.latencyTotalUs / c.delivered) : 0;
+        stats.maxLatencyUs = c.maxLatencyUs;
+        portEXIT_CRITICAL(&statsMux);
+        stats.depth = pending ? (uint16_t)uxQueueMessagesWaiting(queues[priority]) : 0;
+        stats.capacity = capacities[priority];
+        return stats;
+    }
+
+    void resetStats() {
+        portENTER_CRITICAL(&statsMux);
+        for (uint8_t p = 0; p < PRIORITY_COUNT; p++) counters[p] = Counters();
+        portEXIT_CRITICAL(&statsMux);
+    }
+
+private:
+    struct Counters {
+        uint16_t highWater;
+        uint32_t posted;
+        uint32_t dropped;
+        uint32_t delivered;
+        uint64_t latencyTotalUs;
+        uint32_t maxLatencyUs;
+
+        Counters() : highWater(0), posted(0), dropped(0), delivered(0), latencyTotalUs(0), maxLatencyUs(0) {}
+    };
+
+    SemaphoreHandle_t pending;
+    QueueHandle_t queues[PRIORITY_COUNT];
+    uint16_t capacities[PRIORITY_COUNT];
+    Counters counters[PRIORITY_COUNT];
+    portMUX_TYPE statsMux = portMUX_INITIALIZER_UNLOCKED;
+};
+
+#endif
@@ -0,0 +1,98 @@
+#ifndef EVIDENCE_SCORER_H
+#define EVIDENCE_SCORER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "SignatureDatabase.h"
+
+// One matched frame or advertisement, as seen by the scorer.
+struct EvidenceObservation {
+    const uint8_t* mac;
+    uint8_t radio;                                  // EvidenceScorer::RADIO_*
+    int8_t rssi;
+    uint32_t fingerprint;                           // Hash of the frame's capability IEs, 0 = none
+    uint8_t weights[SignatureSet::KIND_COUNT];      // Weight of each matched signature, 0 = no match
+};
+
+struct EvidenceScore {
+    int16_t logOdds;        // Q8 natural log-odds
+    uint8_t certainty;      // 0-100
+    bool alert;             // At or above the alert threshold
+};
+
+// Accumulates log-odds evidence that a device is a surveillance device.
+// Each signature kind contributes logit(weight) - logit(prior) while it keeps
+// matching, so a lone match scores exactly its weight and independent
+// matches add up. History evidence from distinct sightings, a second radio
+// and a steady RSSI or IE fingerprint builds on top, within fixed bounds.
+// Everything decays back towards the prior with a half-life, so a device
+// that goes quiet loses its history.
+//
+// Records are keyed by MAC with the low two bits of the last octet cleared,
+// which puts the WiFi and Bluetooth addresses of a typical single-chip
+// device (base, base+1, base+2) in one record. The table is 4-way set
+// associative and replaces the weakest record in a full set, so update() is
+// bounded time: four probes and a fixed amount of integer math. Not
+// thread-safe; the analysis task owns it.
+class EvidenceScorer {
+public:
+    static const uint8_t CAPACITY = 64;
+    static const uint8_t WAYS = 4;
+
+    static const uint8_t RADIO_WIFI = 0x01;
+    static const uint8_t RADIO_BLE = 0x02;
+
+    static const uint8_t PRIOR_PERCENT = 10;        // Matched device before any signature evidence
+    static const uint8_t DEFAULT_ALERT_CERTAINTY = 60;
+    static const uint32_t HALF_LIFE_MS = 120000;
+    static const uint32_t SIGHTING_INTERVAL_MS = 2000;  // Closer frames are the same sighting
+
+    // History evidence, Q8 nats
+    static const int16_t SIGHTING_BONUS = 26;       // ~0.1 per distinct sighting
+    static const int16_t CROSS_RADIO_BONUS = 256;   // Second radio seen on the same device
+    static const int16_t STEADY_RSSI_BONUS = 13;    // Sighting within STEADY_RSSI_DB of the average
+    static const int16_t FINGERPRINT_BONUS = 13;    // Same capability IEs as last time
+    static const int16_t FINGERPRINT_PENALTY = -128;
+    static const int16_t HISTORY_MIN = -512;
+    static const int16_t HISTORY_MAX = 768;
+    static const uint8_t STEADY_RSSI_DB = 4;
+    static const uint8_t STEADY_RSSI_MIN_SIGHTINGS = 5;
+
+    EvidenceScorer();
+
+    void clear();
+
+    EvidenceScore update(const EvidenceObservation& observation, uint32_t nowMs);
+
+    // Alerts fire at or above this certainty (1-99).
+    void setAlertThreshold(uint8_t certainty);
+    uint8_t getAlertThreshold() const { return alertCertainty; }
+
+    static int16_t weightToLogOdds(uint8_t weight);
+    static uint8_t logOddsToCertainty(int32_t logOdds);
+
+private:
+    struct Record {
+        uint8_t key[6];
+        bool used;
+        uint8_t radios;
+        uint8_t lastRadio;
+        uint16_t sightings;
+        uint32_t lastUpdateMs;
+        uint32_t lastSightingMs;
+        uint32_t fingerprint;
+        int16_t rssiAvgQ4;
+        int16_t kindEvidence[SignatureSet::KIND_COUNT];
+        int16_t history;
+    };
+
+    Record records[CAPACITY];
+    int16_t alertLogOdds;
+    uint8_t alertCertainty;
+
+    static int16_t decay(int16_t value, uint32_t elapsedMs);
+    static int32_t total(const Record& record);
+    Record& findRecord(const uint8_t* key, uint32_t nowMs);
+};
+
+#endif
@@ -2,24 +2,131 @@
 #define THREAT_ANALYZER_H
 
 #include <Arduino.h>
+#include <FS.h>
+#include <atomic>
 #include "EventBus.h"
 #include "DeviceSignatures.h"
+#include "SignatureDatabase.h"
+#include "VerdictCache.h"
+#include "EvidenceScorer.h"
+#include "CuckooFilter.h"
+#include "BatchMatcher.h"
+
+struct DeviceListStats {
+    uint32_t allowlisted;       // Frames dropped because the device is allowlisted
+    uint32_t watchlisted;       // Frames reported because the device is watchlisted
+};
 
 class ThreatAnalyzer {
 public:
+    static constexpr const char* SIGNATURE_FILE = "/signatures.bin";
+    static const size_t MAX_SIGNATURE_FILE_BYTES = 256 * 1024;
+
     void initialize();
     void analyzeWiFiFrame(const WiFiFrameEvent& frame);
     void analyzeBluetoothDevice(const BluetoothDeviceEvent& device);
+
+    // Batch entry points for frames drained from the capture rings. Each
+    // matcher stage runs across the whole batch before the next one starts
+    // (see BatchMatcher.h). The span forms write at most one ThreatEvent per
+    // input into `threats`, which must have room for `count`, and return how
+    // many they wrote; the others publish each threat on the EventBus.
+    static const size_t MAX_BATCH = 32;
+    size_t analyzeWiFiFrames(const WiFiFrameEvent* frames, size_t count, ThreatEvent* threats);
+    size_t analyzeBluetoothDevices(const BluetoothDeviceEvent* devices, size_t count, ThreatEvent* threats);
+    void analyzeWiFiFrames(const WiFiFrameEvent* frames, size_t count);
+    void analyzeBluetoothDevices(const BluetoothDeviceEvent* devices, size_t count);
+
+    // Reads and validates a signature database, then hands it to the
+    // analysis task, which swaps it in before its next frame. Safe to call
+    // from any task while scanning. Returns false and keeps the current set
+    // if the file is missing or invalid; `error` is only set for the latter.
+    bool loadSignatureFile(fs::FS& fs, const char* path, const char** error = nullptr);
+    uint32_t getSignatureRevision() const;  // 0 = compiled-in signatures
+
+    // Repeated beacons reuse the matcher results of the first one for this
+    // long; 0 matches every frame. Counters are updated by the analysis task.
+    void setVerdictCacheTtl(uint32_t ttlMs) { verdictCache.setTtl(ttlMs); }
+    const VerdictCacheStats& getVerdictCacheStats() const { return verdictCache.getStats(); }
+
+    // Matches are scored by accumulated evidence (see EvidenceScorer.h) and
+    // only reported once a device reaches this certainty.
+    void setAlertThreshold(uint8_t certainty) { evidence.setAlertThreshold(certainty); }
+    uint8_t getAlertThreshold() const { return evidence.getAlertThreshold(); }
+    
+    // Runtime device lists, checked by MAC before any signature matching.
+    // Allowlisted devices are never reported; watchlisted ones are reported
+    // at full certainty whether or not they match a signature. Entries can be
+    // added and removed from any task while scanning. Adding a MAC twice
+    // lists it twice, until it is removed twice.
+    enum DeviceList { ALLOWLIST, WATCHLIST };
+    static constexpr const char* DEVICE_LIST_FILE = "/devicelists.bin";
+    static const size_t ALLOWLIST_BUCKETS = 1024;   // 8 KB, ~3900 devices
+    static const size_t WATCHLIST_BUCKETS = 256;    // 2 KB, ~970 devices
+
+    bool addToDeviceList(DeviceList list, const uint8_t* mac);     // False when the list is full
+    bool removeFromDeviceList(DeviceList list, const uint8_t* mac);
+    bool isOnDeviceList(DeviceList list, const uint8_t* mac);
+    size_t getDeviceListSize(DeviceList list);
+    const DeviceListStats& getDeviceListStats() const { return listStats; }
+
+    // Both lists in one CRC-checked file. Loading replaces the lists and
+    // leaves them untouched if the file is missing or invalid; `error` is
+    // only set for the latter.
+    bool loadDeviceLists(fs::FS& fs, const char* path, const char** error = nullptr);
+    bool saveDeviceLists(fs::FS& fs, const char* path);
     
 private:
-    bool matchesNetworkName(const char* ssid);
-    bool matchesMACPrefix(const uint8_t* mac);
-    bool matchesBLEName(const char* name);
-    bool matchesRavenService(const char* uuid);
-    uint8_t calculateCertainty(bool nameMatch, bool macMatch, bool uuidMatch);
-    const char* determineCategory(bool isRaven);
-    void emitThreatDetection(const WiFiFrameEvent& frame, const char* radio, uint8_t certainty);
-    void emitThreatDetection(const BluetoothDeviceEvent& device, const char* radio, uint8_t certainty, const char* category);
+    // Per-frame progress through a batch. PENDING is zero so the state
+    // array doubles as the matchers' skip mask.
+    enum FrameState : uint8_t { FRAME_PENDING = 0, FRAME_CACHED, FRAME_ALLOWED, FRAME_WATCHED };
+    static const uint32_t DEVICE_LIST_MAGIC = 0x4C445346;  // "FSDL"
+    static const uint16_t DEVICE_LIST_VERSION = 1;
+
+    struct DeviceListFileHeader {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t reserved;
+        uint32_t allowlistBuckets;
+        uint32_t watchlistBuckets;
+        uint32_t crc32;             // CRC-32 (IEEE) of both tables
+    };
+
+    struct LoadedSignatures {
+        uint8_t* image;
+        SignatureSet set;
+    };
+
+    SignatureSet builtinSignatures;
+    LoadedSignatures* loadedSignatures = nullptr;  // Only touched by the analysis task
+    std::atomic<LoadedSignatures*> pendingSignatures{nullptr};
+    std::atomic<uint32_t> activeRevision{0};
+    VerdictCache verdictCache;  // WiFi only; cleared whenever the signature set changes
+    EvidenceScorer evidence;
+    ProximityEstimator proximity;   // Fed by every matched or listed frame
+    ThreatEvent batchThreats[MAX_BATCH];
+    uint16_t allowlistTable[ALLOWLIST_BUCKETS * CuckooFilter::SLOTS];
+    uint16_t watchlistTable[WATCHLIST_BUCKETS * CuckooFilter::SLOTS];
+    CuckooFilter allowlist{allowlistTable, ALLOWLIST_BUCKETS};
+    CuckooFilter watchlist{watchlistTable, WATCHLIST_BUCKETS};
+    portMUX_TYPE listMux = portMUX_INITIALIZER_UNLOCKED;   // Guards table writes against lookups
+    SemaphoreHandle_t listWriteLock = nullptr;             // Serializes list writers
+    DeviceListStats listStats = {};
+    
+    static bool buildNameMatcher(const char* const* patterns, size_t count, NameMatcher& matcher);
+    static bool buildUuidSet(const Uuid128* uuids, size_t count, UuidSet& set);
+    static void releaseSignatures(LoadedSignatures* loaded);
+    const SignatureSet& currentSignatures();
+    CuckooFilter& deviceList(DeviceList list);
+    bool findDeviceList(const uint8_t* mac, DeviceList& list);
+    size_t analyzeWiFiBatch(const WiFiFrameEvent* frames, size_t count, ThreatEvent* threats);
+    size_t analyzeBluetoothBatch(const BluetoothDeviceEvent* devices, size_t count, ThreatEvent* threats);
+    static uint32_t fingerprint(const WiFiFrameEvent& frame);
+    static uint32_t fingerprint(const BluetoothDeviceEvent& device);
+    static void buildThreat(const WiFiFrameEvent& frame, const ProximityEstimator::Reading& reading,
+                            const char* radio, uint8_t certainty, const char* category, ThreatEvent& threat);
+    static void buildThreat(const BluetoothDeviceEvent& device, const ProximityEstimator::Reading& reading,
+                            const char* radio, uint8_t certainty, const char* category, ThreatEvent& threat);
     void formatMACAddress(const uint8_t* mac, char* output);
     void extractOUI(const uint8_t* mac, char* output);
 };
@@ -0,0 +1,105 @@
+#include "WiFiFrameParser.h"
+
+#include <string.h>
+
+bool WiFiFrameParser::parse(const uint8_t* frame, size_t length, ManagementFrameView& view) {
+    if (!frame || length < HEADER_LENGTH) return false;
+    if (frameType(frame) != TYPE_MANAGEMENT) return false;
+
+    uint8_t subtype = frameSubtype(frame);
+    size_t offset = HEADER_LENGTH;
+
+    // Order bit on a management frame means a 4-byte HT Control field follows.
+    if (frame[1] & 0x80) {
+        offset += HT_CONTROL_LENGTH;
+    }
+
+    if (subtype == SUBTYPE_BEACON || subtype == SUBTYPE_PROBE_RESPONSE) {
+        offset += FIXED_PARAMS_LENGTH;
+    } else if (subtype != SUBTYPE_PROBE_REQUEST) {
+        return false;
+    }
+
+    if (offset > length) return false;
+
+    memset(&view, 0, sizeof(view));
+    view.subtype = subtype;
+    view.transmitter = frame + 10;
+    view.bssid = frame + 16;
+    view.elements = frame + offset;
+    view.elementsLength = length - offset;
+
+    const uint8_t* cursor = view.elements;
+    const uint8_t* end = frame + length;
+
+    while (end - cursor >= 2) {
+        uint8_t id = cursor[0];
+        uint8_t len = cursor[1];
+        const uint8_t* body = cursor + 2;
+
+        if (len > end - body) {
+            view.truncated = true;
+            break;
+        }
+
+        switch (id) {
+            case IE_SSID:
+                if (!view.ssid && len <= 32) {
+                    view.ssid = body;
+                    view.ssidLength = len;
+                }
+                break;
+            case IE_SUPPORTED_RATES:
+                if (!view.rates) {
+                    view.rates = body;
+                    view.rateCount = len;
+                }
+                break;
+            case IE_EXTENDED_RATES:
+                if (!view.extendedRates) {
+                    view.extendedRates = body;
+                    view.extendedRateCount = len;
+                }
+                break;
+            case IE_DS_PARAMETER_SET:
+                if (len >= 1) {
+                    view.dsChannel = body[0];
+                }
+                break;
+            case IE_HT_CAPABILITIES:
+                if (len >= 26) {
+                    view.htCapabilities = body;
+                }
+                break;
+            case IE_VHT_CAPABILITIES:
+                if (len >= 12) {
+                    view.vhtCapabilities = body;
+                }
+                break;
+            case IE_VENDOR_SPECIFIC:
+                if (len >= 3) {
+                    uint32_t oui = ((uint32_t)body[0] << 16) | ((uint32_t)body[1] << 8) | body[2];
+                    bool seen = false;
+                    for (uint8_t i = 0; i < view.vendorOuiCount; i++) {
+                        if (view.vendorOuis[i] == oui) {
+                            seen = true;
+                            break;
+                        }
+                    }
+                    if (!seen && view.vendorOuiCount < ManagementFrameView::MAX_VENDOR_OUIS) {
+                        view.vendorOuis[view.vendorOuiCount++] = oui;
+                    }
+                }
+                break;
+            default:
+                break;
+        }
+
+        if (view.elementCount < 0xFF) {
+            view.elementCount++;
+        }
+        cursor = body + len;
+    }
+
+    return true;
+}
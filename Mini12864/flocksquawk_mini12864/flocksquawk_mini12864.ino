@@ -12,6 +12,8 @@
 #include <stdint.h>
 #include <SPI.h>
 #include <U8g2lib.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
 #include "esp_wifi.h"
 #include "esp_wifi_types.h"
 
@@ -21,6 +23,7 @@
 #include "src/ThreatAnalyzer.h"
 #include "src/SoundEngine.h"
 #include "src/TelemetryReporter.h"
+#include "src/AlertPolicy.h"
 #include "src/Mini12864Display.h"
 
 // Global system components
@@ -29,67 +32,218 @@ ThreatAnalyzer threatEngine;
 SoundEngine audioSystem;
 TelemetryReporter reporter;
 
-// Event bus handler implementations
-EventBus::WiFiFrameHandler EventBus::wifiHandler = nullptr;
-EventBus::BluetoothHandler EventBus::bluetoothHandler = nullptr;
-EventBus::ThreatHandler EventBus::threatHandler = nullptr;
-EventBus::SystemEventHandler EventBus::systemReadyHandler = nullptr;
-EventBus::AudioHandler EventBus::audioHandler = nullptr;
+// Event bus topics
+EventBus::WiFiFrameTopic EventBus::wifiTopic;
+EventBus::BluetoothTopic EventBus::bluetoothTopic;
+EventBus::WiFiFrameBatchTopic EventBus::wifiBatchTopic;
+EventBus::BluetoothBatchTopic EventBus::bluetoothBatchTopic;
+EventBus::ThreatTopic EventBus::threatTopic;
+EventBus::DevicePresenceTopic EventBus::devicePresenceTopic;
+EventBus::SystemEventTopic EventBus::systemReadyTopic;
+EventBus::AudioTopic EventBus::audioTopic;
+EventBus::Dispatcher EventBus::dispatcher;
+uint8_t EventBus::asyncTypes = 0;
+bool EventBus::dispatching = false;
 
 void EventBus::publishWifiFrame(const WiFiFrameEvent& event) {
-    if (wifiHandler) wifiHandler(event);
+    if (isAsync(EventType::WifiFrameCaptured)) {
+        QueuedEvent queued;
+        queued.type = EventType::WifiFrameCaptured;
+        queued.wifiFrame = event;
+        post(queued);
+        return;
+    }
+    wifiTopic.publish(event);
 }
 
 void EventBus::publishBluetoothDevice(const BluetoothDeviceEvent& event) {
-    if (bluetoothHandler) bluetoothHandler(event);
+    if (isAsync(EventType::BluetoothDeviceFound)) {
+        QueuedEvent queued;
+        queued.type = EventType::BluetoothDeviceFound;
+        queued.bluetoothDevice = event;
+        post(queued);
+        return;
+    }
+    bluetoothTopic.publish(event);
+}
+
+void EventBus::publishWifiFrames(const WiFiFrameEvent* events, size_t count) {
+    wifiBatchTopic.publish(events, count);
+    if (wifiTopic.empty()) return;
+    for (size_t i = 0; i < count; i++) {
+        publishWifiFrame(events[i]);
+    }
+}
+
+void EventBus::publishBluetoothDevices(const BluetoothDeviceEvent* events, size_t count) {
+    bluetoothBatchTopic.publish(events, count);
+    if (bluetoothTopic.empty()) return;
+    for (size_t i = 0; i < count; i++) {
+        publishBluetoothDevice(events[i]);
+    }
 }
 
 void EventBus::publishThreat(const ThreatEvent& event) {
-    if (threatHandler) threatHandler(event);
+    if (isAsync(EventType::ThreatIdentified)) {
+        QueuedEvent queued;
+        queued.type = EventType::ThreatIdentified;
+        queued.threat = event;
+        post(queued);
+        return;
+    }
+    threatTopic.publish(event);
+}
+
+void EventBus::publishDevicePresence(const DevicePresenceEvent& event) {
+    if (isAsync(EventType::DevicePresenceChanged)) {
+        QueuedEvent queued;
+        queued.type = EventType::DevicePresenceChanged;
+        queued.devicePresence = event;
+        post(queued);
+        return;
+    }
+    devicePresenceTopic.publish(event);
 }
 
 void EventBus::publishSystemReady() {
-    if (systemReadyHandler) systemReadyHandler();
+    if (isAsync(EventType::SystemReady)) {
+        QueuedEvent queued;
+        queued.type = EventType::SystemReady;
+        post(queued);
+        return;
+    }
+    systemReadyTopic.publish();
 }
 
 void EventBus::publishAudioRequest(const AudioEvent& event) {
-    if (audioHandler) audioHandler(event);
+    if (isAsync(EventType::AudioPlaybackRequested)) {
+        QueuedEvent queued;
+        queued.type = EventType::AudioPlaybackRequested;
+        queued.audio = event;
+        post(queued);
+        return;
+    }
+    audioTopic.publish(event);
+}
+
+bool EventBus::subscribeWifiFrame(WiFiFrameHandler handler) {
+    return wifiTopic.subscribe(handler);
+}
+
+bool EventBus::subscribeBluetoothDevice(BluetoothHandler handler) {
+    return bluetoothTopic.subscribe(handler);
 }
 
-void EventBus::subscribeWifiFrame(WiFiFrameHandler handler) {
-    wifiHandler = handler;
+bool EventBus::subscribeWifiFrames(WiFiFrameBatchHandler handler) {
+    return wifiBatchTopic.subscribe(handler);
 }
 
-void EventBus::subscribeBluetoothDevice(BluetoothHandler handler) {
-    bluetoothHandler = handler;
+bool EventBus::subscribeBluetoothDevices(BluetoothBatchHandler handler) {
+    return bluetoothBatchTopic.subscribe(handler);
 }
 
-void EventBus::subscribeThreat(ThreatHandler handler) {
-    threatHandler = handler;
+bool EventBus::subscribeThreat(ThreatHandler handler) {
+    return threatTopic.subscribe(handler);
 }
 
-void EventBus::subscribeSystemReady(SystemEventHandler handler) {
-    systemReadyHandler = handler;
+bool EventBus::subscribeDevicePresence(DevicePresenceHandler handler) {
+    return devicePresenceTopic.subscribe(handler);
 }
 
-void EventBus::subscribeAudioRequest(AudioHandler handler) {
-    audioHandler = handler;
+bool EventBus::subscribeSystemReady(SystemEventHandler handler) {
+    return systemReadyTopic.subscribe(handler);
+}
+
+bool EventBus::subscribeAudioRequest(AudioHandler handler) {
+    return audioTopic.subscribe(handler);
+}
+
+bool EventBus::startDispatcher() {
+    const uint16_t depths[Dispatcher::PRIORITY_COUNT] = {
+        URGENT_QUEUE_DEPTH, NORMAL_QUEUE_DEPTH, BACKGROUND_QUEUE_DEPTH
+    };
+    if (!dispatcher.begin(depths)) return false;
+    dispatching = TaskTopology::start(TaskTopology::DISPATCH, dispatchTask, nullptr);
+    return dispatching;
+}
+
+void EventBus::setDelivery(EventType type, Delivery delivery) {
+    uint8_t bit = 1 << (uint8_t)type;
+    if (delivery == ASYNC) asyncTypes |= bit;
+    else asyncTypes &= ~bit;
+}
+
+EventBus::Dispatcher::QueueStats EventBus::getDispatchStats(Dispatcher::Priority priority) {
+    return dispatcher.getStats(priority);
+}
+
+void EventBus::resetDispatchStats() {
+    dispatcher.resetStats();
+}
+
+bool EventBus::isAsync(EventType type) {
+    return dispatching && (asyncTypes & (1 << (uint8_t)type));
+}
+
+void EventBus::post(QueuedEvent& event) {
+    Dispatcher::Priority priority;
+    switch (event.type) {
+        case EventType::ThreatIdentified:
+            priority = Dispatcher::URGENT;
+            break;
+        case EventType::WifiFrameCaptured:
+        case EventType::BluetoothDeviceFound:
+            priority = Dispatcher::BACKGROUND;
+            break;
+        default:
+            priority = Dispatcher::NORMAL;
+            break;
+    }
+    dispatcher.post(priority, event);
+}
+
+void EventBus::deliver(const QueuedEvent& event) {
+    switch (event.type) {
+        case EventType::WifiFrameCaptured:     wifiTopic.publish(event.wifiFrame); break;
+        case EventType::BluetoothDeviceFound:  bluetoothTopic.publish(event.bluetoothDevice); break;
+        case EventType::ThreatIdentified:      threatTopic.publish(event.threat); break;
+        case EventType::DevicePresenceChanged: devicePresenceTopic.publish(event.devicePresence); break;
+        case EventType::SystemReady:           systemReadyTopic.publish(); break;
+        case EventType::AudioPlaybackRequested: audioTopic.publish(event.audio); break;
+    }
+}
+
+void EventBus::dispatchTask(void* param) {
+    // Static: a queued event is too large for this task's stack
+    static QueuedEvent event;
+    Dispatcher::Priority priority;
+    for (;;) {
+        if (!dispatcher.take(event, priority, portMAX_DELAY)) continue;
+        TaskTopology::beginWork(TaskTopology::DISPATCH);
+        deliver(event);
+        TaskTopology::endWork(TaskTopology::DISPATCH);
+    }
 }
 
 // RadioScannerManager implementation
 void RadioScannerManager::initialize() {
+    startAnalysisTask();
     configureWiFiSniffer();
+    startChannelHopTimer();
     configureBluetoothScanner();
 }
 
+void RadioScannerManager::startAnalysisTask() {
+    TaskTopology::start(TaskTopology::ANALYSIS, analysisTask, nullptr);
+    analysisTaskHandle = TaskTopology::handle(TaskTopology::ANALYSIS);
+}
+
 void RadioScannerManager::configureWiFiSniffer() {
     WiFi.mode(WIFI_STA);
     WiFi.disconnect();
     delay(100);
     
-    wifi_promiscuous_filter_t filter;
-    filter.filter_mask = WIFI_PROMIS_FILTER_MASK_MGMT;
-    esp_wifi_set_promiscuous_filter(&filter);
+    CaptureFilter::applyDriverFilter();
     esp_wifi_set_promiscuous(true);
     esp_wifi_set_promiscuous_rx_cb(wifiPacketHandler);
     esp_wifi_set_channel(currentWifiChannel, WIFI_SECOND_CHAN_NONE);
@@ -101,33 +255,55 @@ void RadioScannerManager::configureBluetoothScanner() {
     NimBLEDevice::init("");
     bleScanner = NimBLEDevice::getScan();
     bleScanner->setActiveScan(true);
-    bleScanner->setInterval(100);
-    bleScanner->setWindow(99);
+    bleScanner->setMaxResults(0);          // Stream results to the callback, store none
+    bleScanner->setDuplicateFilter(true);
+    applyBLEScanTiming();
     
     class BLEDeviceObserver : public NimBLEScanCallbacks {
         void onResult(const NimBLEAdvertisedDevice* device) override {
             BluetoothDeviceEvent event;
             memset(&event, 0, sizeof(event));
             
+            // NimBLE keeps the address little-endian; events use display order.
             NimBLEAddress addr = device->getAddress();
-            std::string addrStr = addr.toString();
-            sscanf(addrStr.c_str(), "%02hhx:%02hhx:%02hhx:%02hhx:%02hhx:%02hhx",
-                   &event.mac[0], &event.mac[1], &event.mac[2],
-                   &event.mac[3], &event.mac[4], &event.mac[5]);
-            
+            const uint8_t* addrBytes = addr.getVal();
+            for (int i = 0; i < 6; i++) {
+                event.mac[i] = addrBytes[5 - i];
+            }
+            event.addressType = addr.getType();
             event.rssi = device->getRSSI();
             
-            if (device->haveName()) {
-                strncpy(event.name, device->getName().c_str(), sizeof(event.name) - 1);
+            const std::vector<uint8_t>& payload = device->getPayload();
+            AdvertisementView view;
+            if (BLEAdvertisementParser::parse(payload.data(), payload.size(), view)) {
+                if (view.name) {
+                    size_t len = view.nameLength < sizeof(event.name) - 1 ? view.nameLength : sizeof(event.name) - 1;
+                    memcpy(event.name, view.name, len);
+                }
+                event.hasTxPower = view.hasTxPower;
+                event.txPower = view.txPower;
+                
+                event.serviceUuid16Count = view.uuid16Count;
+                memcpy(event.serviceUuid16, view.uuid16, view.uuid16Count * sizeof(uint16_t));
+                event.serviceUuid128Count = view.uuid128Count;
+                for (uint8_t i = 0; i < view.uuid128Count; i++) {
+                    memcpy(event.serviceUuid128[i], view.uuid128[i], 16);
+                }
+                
+                if (view.hasManufacturerData) {
+                    event.hasManufacturerData = true;
+                    event.manufacturerId = view.manufacturerId;
+                    event.manufacturerDataLength = view.manufacturerDataLength < sizeof(event.manufacturerData)
+                        ? view.manufacturerDataLength : sizeof(event.manufacturerData);
+                    memcpy(event.manufacturerData, view.manufacturerData, event.manufacturerDataLength);
+                }
             }
             
-            event.hasServiceUUID = device->haveServiceUUID();
-            if (event.hasServiceUUID && device->getServiceUUIDCount() > 0) {
-                NimBLEUUID uuid = device->getServiceUUID(0);
-                strncpy(event.serviceUUID, uuid.toString().c_str(), sizeof(event.serviceUUID) - 1);
+            bleAdvertisements = bleAdvertisements + 1;
+            // Analysis runs on the pipeline core, not in the NimBLE host task.
+            if (bleEventRing.push(event) && analysisTaskHandle) {
+                xTaskNotifyGive(analysisTaskHandle);
             }
-            
-            EventBus::publishBluetoothDevice(event);
         }
         
         void onScanEnd(const NimBLEScanResults& results, int reason) override {
@@ -139,92 +315,256 @@ void RadioScannerManager::configureBluetoothScanner() {
     Serial.println("[RF] Bluetooth scanner initialized");
 }
 
+RadioScannerManager::CaptureStats RadioScannerManager::getCaptureStats() {
+    CaptureStats stats;
+    stats.framesQueued = wifiFrameRing.getPushedCount();
+    stats.framesDropped = wifiFrameRing.getDroppedCount();
+    stats.ringHighWater = wifiFrameRing.getHighWater();
+    stats.bleEventsQueued = bleEventRing.getPushedCount();
+    stats.bleEventsDropped = bleEventRing.getDroppedCount();
+    return stats;
+}
+
 void RadioScannerManager::update() {
-    switchWifiChannel();
+    // Without a hop timer (see startChannelHopTimer) hops run from here
+    if (!hopTimer && esp_timer_get_time() - lastHopUs >= (int64_t)currentDwellMs * 1000) {
+        hopChannel();
+    }
     performBLEScan();
 }
 
-void RadioScannerManager::switchWifiChannel() {
-    unsigned long now = millis();
-    if (now - lastChannelSwitch >= CHANNEL_SWITCH_MS) {
-        currentWifiChannel++;
-        if (currentWifiChannel > MAX_WIFI_CHANNEL) {
-            currentWifiChannel = 1;
+// Hops run from an esp_timer so dwell times don't depend on loop() cadence
+// or on whatever the UI/audio code is blocking on. If the timer can't be
+// created or armed, update() hops from loop() instead, and the jitter in
+// HopStats shows what that costs.
+void RadioScannerManager::startChannelHopTimer() {
+    currentDwellMs = CHANNEL_SWITCH_MS;
+    lastHopUs = esp_timer_get_time();
+    
+    esp_timer_create_args_t args = {};
+    args.callback = &RadioScannerManager::hopTimerCallback;
+    args.dispatch_method = ESP_TIMER_TASK;
+    args.name = "wifi_hop";
+    esp_timer_handle_t timer = nullptr;
+    esp_err_t err = esp_timer_create(&args, &timer);
+    if (err == ESP_OK) {
+        hopTimer = timer;
+        err = esp_timer_start_once(timer, (uint64_t)currentDwellMs * 1000);
+        if (err != ESP_OK) {
+            hopTimer = nullptr;
+            esp_timer_delete(timer);
         }
-        esp_wifi_set_channel(currentWifiChannel, WIFI_SECOND_CHAN_NONE);
-        lastChannelSwitch = now;
     }
+    if (err != ESP_OK) {
+        Serial.printf("[RF] Channel hop timer failed (%s), hopping from loop()\n", esp_err_to_name(err));
+    }
+}
+
+void RadioScannerManager::hopTimerCallback(void* arg) {
+    hopChannel();
+    // Failing to re-arm hands hopping to update() rather than parking the
+    // radio on one channel. The timer is idle here, so it can be deleted.
+    esp_timer_handle_t timer = hopTimer;
+    if (esp_timer_start_once(timer, (uint64_t)currentDwellMs * 1000) != ESP_OK) {
+        hopTimer = nullptr;
+        esp_timer_delete(timer);
+    }
+}
+
+void RadioScannerManager::hopChannel() {
+    int64_t now = esp_timer_get_time();
+    int32_t jitter = (int32_t)(now - lastHopUs - (int64_t)currentDwellMs * 1000);
+    uint32_t absJitter = jitter < 0 ? -jitter : jitter;
+    
+    hopStats.hops++;
+    hopStats.lastJitterUs = jitter;
+    if (absJitter > hopStats.maxJitterUs) {
+        hopStats.maxJitterUs = absJitter;
+    }
+    hopStats.meanJitterUs = (hopStats.meanJitterUs * 7 + absJitter) / 8;
+    
+    ChannelHop hop = hopScheduler->next(millis());
+    currentWifiChannel = hop.channel;
+    currentDwellMs = hop.dwellMs;
+    esp_wifi_set_channel(currentWifiChannel, WIFI_SECOND_CHAN_NONE);
+    
+    lastHopUs = now;
+}
+
+RadioScannerManager::HopStats RadioScannerManager::getHopStats() {
+    return hopStats;
+}
+
+void RadioScannerManager::setHopScheduler(ChannelHopScheduler* scheduler) {
+    hopScheduler = scheduler ? scheduler : &defaultHopScheduler;
+}
+
+ChannelHopScheduler* RadioScannerManager::getHopScheduler() {
+    return hopScheduler;
+}
+
+void RadioScannerManager::noteThreat(const ThreatEvent& threat) {
+    if (threat.channel == 0 || strcmp(threat.radioType, "wifi") != 0) return;
+    hopScheduler->recordMatch(threat.channel, millis());
 }
 
 void RadioScannerManager::performBLEScan() {
+    if (!bleScanner) return;
     unsigned long now = millis();
-    if (now - lastBLEScan >= BLE_SCAN_INTERVAL_MS && !isScanningBLE) {
-        if (bleScanner && !bleScanner->isScanning()) {
-            bleScanner->start(BLE_SCAN_SECONDS, false);
-            isScanningBLE = true;
-            lastBLEScan = now;
+    
+    if (!BLE_CONTINUOUS_SCAN) {
+        if (now - lastBLEScan >= BLE_SCAN_INTERVAL_MS && !isScanningBLE) {
+            if (!bleScanner->isScanning()) {
+                bleScanner->start(BLE_SCAN_SECONDS * 1000, false);
+                isScanningBLE = true;
+                lastBLEScan = now;
+            }
+        }
+        
+        if (isScanningBLE && !bleScanner->isScanning()) {
+            if (now - lastBLEScan > BLE_SCAN_SECONDS * 1000) {
+                bleScanner->clearResults();
+                isScanningBLE = false;
+            }
         }
+        return;
     }
     
-    if (isScanningBLE && bleScanner && !bleScanner->isScanning()) {
-        if (now - lastBLEScan > BLE_SCAN_SECONDS * 1000) {
-            bleScanner->clearResults();
-            isScanningBLE = false;
-        }
+    if (isScanningBLE && bleScanner->isScanning() && now - lastBLEScan < BLE_SCAN_RESTART_MS) {
+        return;
+    }
+    
+    // Periodic restart: clears the controller's duplicate filter so nearby
+    // devices are reported again, and re-tunes timing to advertisement
+    // density. Busy air gets longer intervals (less time lost switching
+    // between 37/38/39), quiet air cycles the channels faster.
+    if (isScanningBLE) {
+        uint32_t elapsed = now - lastBLEScan;
+        uint32_t ads = bleAdvertisements - bleAdsAtRestart;
+        uint32_t adsPerSec = elapsed ? ads * 1000 / elapsed : 0;
+        bleIntervalMs = (adsPerSec >= BLE_DENSE_ADS_PER_SEC) ? BLE_SCAN_INTERVAL_DENSE_MS
+                                                             : BLE_SCAN_INTERVAL_SPARSE_MS;
+        bleScanner->stop();
+        bleRestarts++;
     }
+    
+    applyBLEScanTiming();
+    bleAdsAtRestart = bleAdvertisements;
+    isScanningBLE = bleScanner->start(0, false);
+    lastBLEScan = now;
 }
 
-struct WiFi80211Header {
-    uint16_t frameControl;
-    uint16_t duration;
-    uint8_t destination[6];
-    uint8_t source[6];
-    uint8_t bssid[6];
-    uint16_t sequence;
-};
+uint16_t RadioScannerManager::bleWindowMs() {
+    uint16_t window = (uint32_t)bleIntervalMs * bleDutyPercent / 100;
+    return window > 0 ? window : 1;
+}
+
+void RadioScannerManager::applyBLEScanTiming() {
+    if (!bleScanner) return;
+    bleScanner->setInterval(bleIntervalMs);
+    bleScanner->setWindow(bleWindowMs());
+}
+
+void RadioScannerManager::setBLEDutyCycle(uint8_t percent) {
+    if (percent < 10) percent = 10;
+    if (percent > 100) percent = 100;
+    bleDutyPercent = percent;
+}
+
+RadioScannerManager::BLEScanStats RadioScannerManager::getBLEScanStats() {
+    BLEScanStats stats;
+    stats.advertisements = bleAdvertisements;
+    stats.restarts = bleRestarts;
+    stats.intervalMs = bleIntervalMs;
+    stats.windowMs = bleWindowMs();
+    return stats;
+}
 
 void RadioScannerManager::wifiPacketHandler(void* buffer, wifi_promiscuous_pkt_type_t type) {
     const wifi_promiscuous_pkt_t* packet = (wifi_promiscuous_pkt_t*)buffer;
-    const uint8_t* rawData = packet->payload;
-    
-    if (packet->rx_ctrl.sig_len < 24) return;
+    if (!CaptureFilter::accept(type, packet->payload, packet->rx_ctrl.sig_len,
+                               packet->rx_ctrl.channel)) return;
+    hopScheduler->recordFrame(packet->rx_ctrl.channel);
     
-    const WiFi80211Header* header = (const WiFi80211Header*)rawData;
-    uint8_t frameSubtype = (header->frameControl & 0x00F0) >> 4;
+    size_t frameLength = packet->rx_ctrl.sig_len - WiFiFrameParser::FCS_LENGTH;
     
-    bool isProbeRequest = (frameSubtype == 0x04);
-    bool isBeacon = (frameSubtype == 0x08);
-    
-    if (!isProbeRequest && !isBeacon) return;
+    ManagementFrameView view;
+    if (!WiFiFrameParser::parse(packet->payload, frameLength, view)) return;
     
     WiFiFrameEvent event;
     memset(&event, 0, sizeof(event));
     
-    memcpy(event.mac, header->source, 6);
+    memcpy(event.mac, view.transmitter, 6);
     event.rssi = packet->rx_ctrl.rssi;
-    event.frameSubtype = frameSubtype;
-    event.channel = RadioScannerManager::currentWifiChannel;
-    
-    const uint8_t* payload = rawData + sizeof(WiFi80211Header);
+    event.frameSubtype = view.subtype;
+    event.channel = packet->rx_ctrl.channel;
     
-    if (isBeacon) {
-        payload += 12;
+    if (view.ssid) {
+        memcpy(event.ssid, view.ssid, view.ssidLength);
+        event.ssid[view.ssidLength] = '\0';
     }
     
-    if (packet->rx_ctrl.sig_len > (payload - rawData) + 2) {
-        if (payload[0] == 0 && payload[1] <= 32) {
-            size_t ssidLen = payload[1];
-            memcpy(event.ssid, payload + 2, ssidLen);
-            event.ssid[ssidLen] = '\0';
-        }
+    event.dsChannel = view.dsChannel;
+    event.rateCount = view.rateCount + view.extendedRateCount;
+    if (view.htCapabilities) {
+        event.hasHTCapabilities = true;
+        event.htCapabilityInfo = view.htCapabilities[0] | (view.htCapabilities[1] << 8);
     }
+    if (view.vhtCapabilities) {
+        event.hasVHTCapabilities = true;
+        memcpy(&event.vhtCapabilityInfo, view.vhtCapabilities, sizeof(event.vhtCapabilityInfo));
+    }
+    event.vendorOuiCount = view.vendorOuiCount;
+    memcpy(event.vendorOuis, view.vendorOuis, view.vendorOuiCount * sizeof(uint32_t));
     
-    EventBus::publishWifiFrame(event);
+    // Hand off to the analysis task so the driver callback returns immediately.
+    if (wifiFrameRing.push(event) && analysisTaskHandle) {
+        xTaskNotifyGive(analysisTaskHandle);
+    }
+}
+
+void RadioScannerManager::analysisTask(void* param) {
+    // Static: a batch of events is too large for this task's stack
+    static WiFiFrameEvent frames[ANALYSIS_BATCH_SIZE];
+    static BluetoothDeviceEvent devices[ANALYSIS_BATCH_SIZE];
+    size_t count;
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        TaskTopology::beginWork(TaskTopology::ANALYSIS);
+        // One batch from each ring per pass, so steady WiFi traffic cannot
+        // starve BLE until its ring overflows.
+        bool more;
+        do {
+            more = false;
+            if ((count = wifiFrameRing.popBatch(frames, ANALYSIS_BATCH_SIZE)) > 0) {
+                EventBus::publishWifiFrames(frames, count);
+                more = true;
+            }
+            if ((count = bleEventRing.popBatch(devices, ANALYSIS_BATCH_SIZE)) > 0) {
+                EventBus::publishBluetoothDevices(devices, count);
+                more = true;
+            }
+        } while (more);
+        TaskTopology::endWork(TaskTopology::ANALYSIS);
+    }
 }
 
 uint8_t RadioScannerManager::currentWifiChannel = 1;
-unsigned long RadioScannerManager::lastChannelSwitch = 0;
+uint16_t RadioScannerManager::currentDwellMs = RadioScannerManager::CHANNEL_SWITCH_MS;
+std::atomic<esp_timer_handle_t> RadioScannerManager::hopTimer{nullptr};
+int64_t RadioScannerManager::lastHopUs = 0;
+RadioScannerManager::HopStats RadioScannerManager::hopStats = {};
+AdaptiveHopScheduler RadioScannerManager::defaultHopScheduler(RadioScannerManager::MAX_WIFI_CHANNEL);
+ChannelHopScheduler* RadioScannerManager::hopScheduler = &RadioScannerManager::defaultHopScheduler;
+FrameRing<WiFiFrameEvent, RadioScannerManager::WIFI_FRAME_RING_SIZE> RadioScannerManager::wifiFrameRing;
+TaskHandle_t RadioScannerManager::analysisTaskHandle = nullptr;
 unsigned long RadioScannerManager::lastBLEScan = 0;
+uint8_t RadioScannerManager::bleDutyPercent = 100;
+uint16_t RadioScannerManager::bleIntervalMs = RadioScannerManager::BLE_SCAN_INTERVAL_SPARSE_MS;
+volatile uint32_t RadioScannerManager::bleAdvertisements = 0;
+uint32_t RadioScannerManager::bleAdsAtRestart = 0;
+uint32_t RadioScannerManager::bleRestarts = 0;
+FrameRing<BluetoothDeviceEvent, RadioScannerManager::BLE_EVENT_RING_SIZE> RadioScannerManager::bleEventRing;
 NimBLEScan* RadioScannerManager::bleScanner = nullptr;
 bool RadioScannerManager::isScanningBLE = false;
 
@@ -234,117 +574,479 @@ uint8_t RadioScannerManager::getCurrentWifiChannel() {
 
 // ThreatAnalyzer implementation
 void ThreatAnalyzer::initialize() {
-    // Analyzer ready
+    // Compiled-in signatures; a loaded database replaces them via loadSignatureFile()
+    builtinSignatures.macPrefixes = DeviceProfiles::MACPrefixTable;
+    buildNameMatcher(DeviceProfiles::NetworkNames, DeviceProfiles::NetworkNameCount, builtinSignatures.networkNames);
+    buildNameMatcher(DeviceProfiles::BLEIdentifiers, DeviceProfiles::BLEIdentifierCount, builtinSignatures.bleNames);
+    buildUuidSet(DeviceProfiles::RavenServices, DeviceProfiles::RavenServiceCount, builtinSignatures.services);
+    builtinSignatures.info[SignatureSet::MAC_PREFIX] = DeviceProfiles::MACPrefixInfo;
+    builtinSignatures.info[SignatureSet::NETWORK_NAME] = DeviceProfiles::NetworkNameInfo;
+    builtinSignatures.info[SignatureSet::BLE_NAME] = DeviceProfiles::BLEIdentifierInfo;
+    builtinSignatures.info[SignatureSet::SERVICE_UUID] = DeviceProfiles::RavenServiceInfo;
+    listWriteLock = xSemaphoreCreateMutex();
 }
 
-void ThreatAnalyzer::analyzeWiFiFrame(const WiFiFrameEvent& frame) {
-    bool nameMatch = strlen(frame.ssid) > 0 && matchesNetworkName(frame.ssid);
-    bool macMatch = matchesMACPrefix(frame.mac);
+bool ThreatAnalyzer::buildNameMatcher(const char* const* patterns, size_t count, NameMatcher& matcher) {
+    size_t bytes = NameMatcher::requiredBytes(patterns, count);
+    void* buffer = bytes ? malloc(bytes) : nullptr;
+    NameAutomaton automaton;
     
-    if (nameMatch || macMatch) {
-        uint8_t certainty = calculateCertainty(nameMatch, macMatch, false);
-        emitThreatDetection(frame, "wifi", certainty);
+    if (!buffer || !NameMatcher::build(patterns, count, buffer, bytes, automaton)) {
+        free(buffer);
+        return false;
     }
+    matcher = NameMatcher(automaton);
+    return true;
 }
 
-void ThreatAnalyzer::analyzeBluetoothDevice(const BluetoothDeviceEvent& device) {
-    bool nameMatch = strlen(device.name) > 0 && matchesBLEName(device.name);
-    bool macMatch = matchesMACPrefix(device.mac);
-    bool uuidMatch = device.hasServiceUUID && matchesRavenService(device.serviceUUID);
+bool ThreatAnalyzer::buildUuidSet(const Uuid128* uuids, size_t count, UuidSet& set) {
+    size_t bytes = UuidSet::requiredBytes(count);
+    void* buffer = bytes ? malloc(bytes) : nullptr;
+    UuidSetTable table;
     
-    if (nameMatch || macMatch || uuidMatch) {
-        uint8_t certainty = calculateCertainty(nameMatch, macMatch, uuidMatch);
-        const char* category = determineCategory(uuidMatch);
-        emitThreatDetection(device, "bluetooth", certainty, category);
+    if (!buffer || !UuidSet::build(uuids, count, buffer, bytes, table)) {
+        free(buffer);
+        return false;
     }
+    set = UuidSet(table);
+    return true;
 }
 
-bool ThreatAnalyzer::matchesNetworkName(const char* ssid) {
-    if (!ssid) return false;
+bool ThreatAnalyzer::loadSignatureFile(fs::FS& fs, const char* path, const char** error) {
+    if (error) *error = nullptr;
+    if (!fs.exists(path)) return false;
     
-    for (size_t i = 0; i < DeviceProfiles::NetworkNameCount; i++) {
-        if (strcasestr(ssid, DeviceProfiles::NetworkNames[i])) {
-            return true;
-        }
+    File file = fs.open(path, FILE_READ);
+    if (!file) return false;
+    
+    size_t length = file.size();
+    const char* problem = nullptr;
+    LoadedSignatures* loaded = new LoadedSignatures();
+    loaded->image = nullptr;
+    
+    if (length == 0 || length > MAX_SIGNATURE_FILE_BYTES) {
+        problem = "bad file size";
+    } else if (!(loaded->image = (uint8_t*)malloc(length))) {
+        problem = "out of memory";
+    } else if (file.read(loaded->image, length) != length) {
+        problem = "short read";
+    } else {
+        SignatureDatabase::parse(loaded->image, length, loaded->set, &problem);
+    }
+    file.close();
+    
+    if (problem) {
+        releaseSignatures(loaded);
+        if (error) *error = problem;
+        return false;
     }
-    return false;
+    
+    // A set still waiting for the analysis task was never read, so it can go now
+    releaseSignatures(pendingSignatures.exchange(loaded));
+    return true;
+}
+
+uint32_t ThreatAnalyzer::getSignatureRevision() const {
+    return activeRevision.load();
+}
+
+const SignatureSet& ThreatAnalyzer::currentSignatures() {
+    // Only the analysis task calls this, and it is between frames here, so
+    // nothing can still be reading the set being replaced.
+    LoadedSignatures* pending = pendingSignatures.exchange(nullptr);
+    if (pending) {
+        releaseSignatures(loadedSignatures);
+        loadedSignatures = pending;
+        activeRevision.store(pending->set.revision);
+        verdictCache.clear();
+    }
+    return loadedSignatures ? loadedSignatures->set : builtinSignatures;
+}
+
+void ThreatAnalyzer::releaseSignatures(LoadedSignatures* loaded) {
+    if (!loaded) return;
+    free(loaded->image);
+    delete loaded;
+}
+
+CuckooFilter& ThreatAnalyzer::deviceList(DeviceList list) {
+    return list == ALLOWLIST ? allowlist : watchlist;
 }
 
-bool ThreatAnalyzer::matchesMACPrefix(const uint8_t* mac) {
-    char macStr[9];
-    snprintf(macStr, sizeof(macStr), "%02x:%02x:%02x", mac[0], mac[1], mac[2]);
+// Writers take listWriteLock, so only they change the tables. An insert
+// plans its eviction walk against the live table with that alone, and holds
+// listMux just to apply the planned slot writes: findDeviceList() on the
+// analysis task never waits out a walk. No contains() check first, since a
+// fingerprint collision would then report a MAC as added without storing it.
+bool ThreatAnalyzer::addToDeviceList(DeviceList list, const uint8_t* mac) {
+    CuckooFilter::Move* moves = (CuckooFilter::Move*)malloc(sizeof(CuckooFilter::Move) * CuckooFilter::MAX_MOVES);
+    if (!moves) return false;
+    xSemaphoreTake(listWriteLock, portMAX_DELAY);
+    CuckooFilter& filter = deviceList(list);
+    size_t moveCount = filter.planInsert(mac, moves);
+    portENTER_CRITICAL(&listMux);
+    filter.commitInsert(moves, moveCount);
+    portEXIT_CRITICAL(&listMux);
+    xSemaphoreGive(listWriteLock);
+    free(moves);
+    return moveCount > 0;
+}
+
+bool ThreatAnalyzer::removeFromDeviceList(DeviceList list, const uint8_t* mac) {
+    xSemaphoreTake(listWriteLock, portMAX_DELAY);
+    portENTER_CRITICAL(&listMux);
+    bool removed = deviceList(list).remove(mac);
+    portEXIT_CRITICAL(&listMux);
+    xSemaphoreGive(listWriteLock);
+    return removed;
+}
+
+bool ThreatAnalyzer::isOnDeviceList(DeviceList list, const uint8_t* mac) {
+    portENTER_CRITICAL(&listMux);
+    bool found = deviceList(list).contains(mac);
+    portEXIT_CRITICAL(&listMux);
+    return found;
+}
+
+size_t ThreatAnalyzer::getDeviceListSize(DeviceList list) {
+    portENTER_CRITICAL(&listMux);
+    size_t size = deviceList(list).size();
+    portEXIT_CRITICAL(&listMux);
+    return size;
+}
+
+bool ThreatAnalyzer::loadDeviceLists(fs::FS& fs, const char* path, const char** error) {
+    if (error) *error = nullptr;
+    if (!fs.exists(path)) return false;
+    
+    File file = fs.open(path, FILE_READ);
+    if (!file) return false;
     
-    for (size_t i = 0; i < DeviceProfiles::MACPrefixCount; i++) {
-        if (strncasecmp(macStr, DeviceProfiles::MACPrefixes[i], 8) == 0) {
-            return true;
+    const size_t allowBytes = sizeof(allowlistTable);
+    const size_t watchBytes = sizeof(watchlistTable);
+    DeviceListFileHeader header;
+    const char* problem = nullptr;
+    uint8_t* tables = nullptr;
+    
+    if (file.read((uint8_t*)&header, sizeof(header)) != sizeof(header)) {
+        problem = "short read";
+    } else if (header.magic != DEVICE_LIST_MAGIC || header.version != DEVICE_LIST_VERSION) {
+        problem = "not a device list file";
+    } else if (header.allowlistBuckets != ALLOWLIST_BUCKETS || header.watchlistBuckets != WATCHLIST_BUCKETS) {
+        problem = "list size mismatch";
+    } else if (!(tables = (uint8_t*)malloc(allowBytes + watchBytes))) {
+        problem = "out of memory";
+    } else if (file.read(tables, allowBytes + watchBytes) != allowBytes + watchBytes) {
+        problem = "short read";
+    } else if (SignatureDatabase::crc32(tables, allowBytes + watchBytes) != header.crc32) {
+        problem = "checksum mismatch";
+    }
+    file.close();
+    
+    if (problem) {
+        free(tables);
+        if (error) *error = problem;
+        return false;
+    }
+    
+    xSemaphoreTake(listWriteLock, portMAX_DELAY);
+    portENTER_CRITICAL(&listMux);
+    allowlist.restore((const uint16_t*)tables, ALLOWLIST_BUCKETS);
+    watchlist.restore((const uint16_t*)(tables + allowBytes), WATCHLIST_BUCKETS);
+    portEXIT_CRITICAL(&listMux);
+    xSemaphoreGive(listWriteLock);
+    free(tables);
+    return true;
+}
+
+bool ThreatAnalyzer::saveDeviceLists(fs::FS& fs, const char* path) {
+    // Snapshot with writers held off so the file never holds a half-applied
+    // insert. Lookups only read, so they need not wait for the copy.
+    const size_t allowBytes = sizeof(allowlistTable);
+    const size_t watchBytes = sizeof(watchlistTable);
+    uint8_t* tables = (uint8_t*)malloc(allowBytes + watchBytes);
+    if (!tables) return false;
+    xSemaphoreTake(listWriteLock, portMAX_DELAY);
+    memcpy(tables, allowlistTable, allowBytes);
+    memcpy(tables + allowBytes, watchlistTable, watchBytes);
+    xSemaphoreGive(listWriteLock);
+    
+    DeviceListFileHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = DEVICE_LIST_MAGIC;
+    header.version = DEVICE_LIST_VERSION;
+    header.allowlistBuckets = ALLOWLIST_BUCKETS;
+    header.watchlistBuckets = WATCHLIST_BUCKETS;
+    header.crc32 = SignatureDatabase::crc32(tables, allowBytes + watchBytes);
+    
+    File file = fs.open(path, FILE_WRITE);
+    bool written = file &&
+        file.write((const uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+        file.write(tables, allowBytes + watchBytes) == allowBytes + watchBytes;
+    if (file) file.close();
+    free(tables);
+    return written;
+}
+
+// Allowlist wins for a device on both lists. Empty lists skip the lookup.
+bool ThreatAnalyzer::findDeviceList(const uint8_t* mac, DeviceList& list) {
+    portENTER_CRITICAL(&listMux);
+    bool allowed = allowlist.size() > 0 && allowlist.contains(mac);
+    bool watched = !allowed && watchlist.size() > 0 && watchlist.contains(mac);
+    portEXIT_CRITICAL(&listMux);
+    
+    if (allowed) {
+        list = ALLOWLIST;
+        listStats.allowlisted++;
+    } else if (watched) {
+        list = WATCHLIST;
+        listStats.watchlisted++;
+    }
+    return allowed || watched;
+}
+
+void ThreatAnalyzer::analyzeWiFiFrame(const WiFiFrameEvent& frame) {
+    analyzeWiFiFrames(&frame, 1);
+}
+
+void ThreatAnalyzer::analyzeBluetoothDevice(const BluetoothDeviceEvent& device) {
+    analyzeBluetoothDevices(&device, 1);
+}
+
+void ThreatAnalyzer::analyzeWiFiFrames(const WiFiFrameEvent* frames, size_t count) {
+    for (size_t start = 0; start < count; start += MAX_BATCH) {
+        size_t chunk = count - start < MAX_BATCH ? count - start : MAX_BATCH;
+        size_t found = analyzeWiFiBatch(frames + start, chunk, batchThreats);
+        for (size_t i = 0; i < found; i++) {
+            EventBus::publishThreat(batchThreats[i]);
+        }
+    }
+}
+
+void ThreatAnalyzer::analyzeBluetoothDevices(const BluetoothDeviceEvent* devices, size_t count) {
+    for (size_t start = 0; start < count; start += MAX_BATCH) {
+        size_t chunk = count - start < MAX_BATCH ? count - start : MAX_BATCH;
+        size_t found = analyzeBluetoothBatch(devices + start, chunk, batchThreats);
+        for (size_t i = 0; i < found; i++) {
+            EventBus::publishThreat(batchThreats[i]);
         }
     }
-    return false;
 }
 
-bool ThreatAnalyzer::matchesBLEName(const char* name) {
-    if (!name) return false;
+size_t ThreatAnalyzer::analyzeWiFiFrames(const WiFiFrameEvent* frames, size_t count, ThreatEvent* threats) {
+    size_t found = 0;
+    for (size_t start = 0; start < count; start += MAX_BATCH) {
+        size_t chunk = count - start < MAX_BATCH ? count - start : MAX_BATCH;
+        found += analyzeWiFiBatch(frames + start, chunk, threats + found);
+    }
+    return found;
+}
+
+size_t ThreatAnalyzer::analyzeBluetoothDevices(const BluetoothDeviceEvent* devices, size_t count, ThreatEvent* threats) {
+    size_t found = 0;
+    for (size_t start = 0; start < count; start += MAX_BATCH) {
+        size_t chunk = count - start < MAX_BATCH ? count - start : MAX_BATCH;
+        found += analyzeBluetoothBatch(devices + start, chunk, threats + found);
+    }
+    return found;
+}
+
+size_t ThreatAnalyzer::analyzeWiFiBatch(const WiFiFrameEvent* frames, size_t count, ThreatEvent* threats) {
+    const SignatureSet& signatures = currentSignatures();
+    uint32_t nowMs = millis();
+    uint8_t state[MAX_BATCH];
+    VerdictCache::Key keys[MAX_BATCH];
+    BatchMatch matches[MAX_BATCH];
+    BatchMatcher::reset(matches, count);
     
-    for (size_t i = 0; i < DeviceProfiles::BLEIdentifierCount; i++) {
-        if (strcasestr(name, DeviceProfiles::BLEIdentifiers[i])) {
-            return true;
+    // Listed devices skip matching, and repeated beacons reuse their verdict
+    for (size_t i = 0; i < count; i++) {
+        const WiFiFrameEvent& frame = frames[i];
+        DeviceList listed;
+        WiFiVerdict verdict;
+        if (findDeviceList(frame.mac, listed)) {
+            state[i] = listed == ALLOWLIST ? FRAME_ALLOWED : FRAME_WATCHED;
+            continue;
+        }
+        keys[i] = VerdictCache::makeKey(frame.mac, frame.ssid, strlen(frame.ssid));
+        if (verdictCache.lookup(keys[i], nowMs, verdict)) {
+            state[i] = FRAME_CACHED;
+            matches[i].nameIndex = verdict.nameIndex;
+            matches[i].macIndex = verdict.macIndex;
+        } else {
+            state[i] = FRAME_PENDING;
         }
     }
-    return false;
+    
+    BatchMatcher::matchMacPrefixes(signatures.macPrefixes, frames, count, state, matches);
+    BatchMatcher::matchNames(signatures, SignatureSet::NETWORK_NAME, frames, count, &WiFiFrameEvent::ssid, state, matches);
+    
+    size_t found = 0;
+    for (size_t i = 0; i < count; i++) {
+        const WiFiFrameEvent& frame = frames[i];
+        if (state[i] == FRAME_ALLOWED) continue;
+        if (state[i] == FRAME_WATCHED) {
+            buildThreat(frame, proximity.update(frame.mac, frame.rssi, nowMs), "wifi", 100, "watchlist", threats[found++]);
+            continue;
+        }
+        if (state[i] == FRAME_PENDING) {
+            WiFiVerdict verdict;
+            verdict.nameIndex = matches[i].nameIndex;
+            verdict.macIndex = matches[i].macIndex;
+            verdictCache.store(keys[i], nowMs, verdict);
+        }
+        
+        int nameIndex = matches[i].nameIndex;
+        int macIndex = matches[i].macIndex;
+        bool nameMatch = nameIndex != BatchMatcher::NO_MATCH;
+        bool macMatch = macIndex != BatchMatcher::NO_MATCH;
+        if (!nameMatch && !macMatch) continue;
+        
+        SignatureInfo nameInfo = signatures.getInfo(SignatureSet::NETWORK_NAME, nameIndex);
+        SignatureInfo macInfo = signatures.getInfo(SignatureSet::MAC_PREFIX, macIndex);
+        EvidenceObservation observation;
+        observation.mac = frame.mac;
+        observation.radio = EvidenceScorer::RADIO_WIFI;
+        observation.rssi = frame.rssi;
+        observation.fingerprint = fingerprint(frame);
+        memset(observation.weights, 0, sizeof(observation.weights));
+        if (nameMatch) observation.weights[SignatureSet::NETWORK_NAME] = nameInfo.weight;
+        if (macMatch) observation.weights[SignatureSet::MAC_PREFIX] = macInfo.weight;
+        
+        EvidenceScore score = evidence.update(observation, nowMs);
+        ProximityEstimator::Reading reading = proximity.update(frame.mac, frame.rssi, nowMs);
+        if (score.alert) {
+            uint8_t category = nameMatch ? nameInfo.category : macInfo.category;
+            buildThreat(frame, reading, "wifi", score.certainty, SignatureSet::categoryName(category), threats[found++]);
+        }
+    }
+    return found;
 }
 
-bool ThreatAnalyzer::matchesRavenService(const char* uuid) {
-    if (!uuid) return false;
+size_t ThreatAnalyzer::analyzeBluetoothBatch(const BluetoothDeviceEvent* devices, size_t count, ThreatEvent* threats) {
+    const SignatureSet& signatures = currentSignatures();
+    uint32_t nowMs = millis();
+    uint8_t state[MAX_BATCH];
+    BatchMatch matches[MAX_BATCH];
+    BatchMatcher::reset(matches, count);
     
-    for (size_t i = 0; i < DeviceProfiles::RavenServiceCount; i++) {
-        if (strcasecmp(uuid, DeviceProfiles::RavenServices[i]) == 0) {
-            return true;
+    for (size_t i = 0; i < count; i++) {
+        DeviceList listed;
+        if (findDeviceList(devices[i].mac, listed)) {
+            state[i] = listed == ALLOWLIST ? FRAME_ALLOWED : FRAME_WATCHED;
+        } else {
+            state[i] = FRAME_PENDING;
+        }
+    }
+    
+    BatchMatcher::matchMacPrefixes(signatures.macPrefixes, devices, count, state, matches);
+    BatchMatcher::matchNames(signatures, SignatureSet::BLE_NAME, devices, count, &BluetoothDeviceEvent::name, state, matches);
+    BatchMatcher::matchServices(signatures.services, devices, count, state, matches);
+    
+    size_t found = 0;
+    for (size_t i = 0; i < count; i++) {
+        const BluetoothDeviceEvent& device = devices[i];
+        if (state[i] == FRAME_ALLOWED) continue;
+        if (state[i] == FRAME_WATCHED) {
+            buildThreat(device, proximity.update(device.mac, device.rssi, nowMs), "bluetooth", 100, "watchlist", threats[found++]);
+            continue;
+        }
+        
+        int nameIndex = matches[i].nameIndex;
+        int macIndex = matches[i].macIndex;
+        int uuidIndex = matches[i].uuidIndex;
+        bool nameMatch = nameIndex != BatchMatcher::NO_MATCH;
+        bool macMatch = macIndex != BatchMatcher::NO_MATCH;
+        bool uuidMatch = uuidIndex != BatchMatcher::NO_MATCH;
+        if (!nameMatch && !macMatch && !uuidMatch) continue;
+        
+        SignatureInfo nameInfo = signatures.getInfo(SignatureSet::BLE_NAME, nameIndex);
+        SignatureInfo macInfo = signatures.getInfo(SignatureSet::MAC_PREFIX, macIndex);
+        SignatureInfo uuidInfo = signatures.getInfo(SignatureSet::SERVICE_UUID, uuidIndex);
+        EvidenceObservation observation;
+        observation.mac = device.mac;
+        observation.radio = EvidenceScorer::RADIO_BLE;
+        observation.rssi = device.rssi;
+        observation.fingerprint = fingerprint(device);
+        memset(observation.weights, 0, sizeof(observation.weights));
+        if (nameMatch) observation.weights[SignatureSet::BLE_NAME] = nameInfo.weight;
+        if (macMatch) observation.weights[SignatureSet::MAC_PREFIX] = macInfo.weight;
+        if (uuidMatch) observation.weights[SignatureSet::SERVICE_UUID] = uuidInfo.weight;
+        
+        EvidenceScore score = evidence.update(observation, nowMs);
+        ProximityEstimator::Reading reading = proximity.update(device.mac, device.rssi, nowMs);
+        if (score.alert) {
+            uint8_t category = uuidMatch ? uuidInfo.category : nameMatch ? nameInfo.category : macInfo.category;
+            buildThreat(device, reading, "bluetooth", score.certainty, SignatureSet::categoryName(category), threats[found++]);
         }
     }
-    return false;
+    return found;
 }
 
-uint8_t ThreatAnalyzer::calculateCertainty(bool nameMatch, bool macMatch, bool uuidMatch) {
-    if (nameMatch && macMatch && uuidMatch) return 100;
-    if (nameMatch && macMatch) return 95;
-    if (uuidMatch) return 90;
-    if (nameMatch || macMatch) return 85;
-    return 70;
+// Hash of the capability IEs, which stay fixed for one piece of hardware
+uint32_t ThreatAnalyzer::fingerprint(const WiFiFrameEvent& frame) {
+    uint32_t h = 2166136261u;
+    uint32_t fields[4] = {
+        (uint32_t)frame.rateCount | ((uint32_t)frame.hasHTCapabilities << 8) |
+            ((uint32_t)frame.hasVHTCapabilities << 9) | ((uint32_t)frame.vendorOuiCount << 16),
+        frame.htCapabilityInfo,
+        frame.vhtCapabilityInfo,
+        frame.vendorOuiCount > 0 ? frame.vendorOuis[0] : 0
+    };
+    for (uint8_t i = 0; i < 4; i++) {
+        h = (h ^ fields[i]) * 16777619u;
+    }
+    return h ? h : 1;
 }
 
-const char* ThreatAnalyzer::determineCategory(bool isRaven) {
-    return isRaven ? "acoustic_detector" : "surveillance_device";
+uint32_t ThreatAnalyzer::fingerprint(const BluetoothDeviceEvent& device) {
+    uint32_t h = 2166136261u;
+    uint32_t fields[3] = {
+        (uint32_t)device.addressType | ((uint32_t)device.serviceUuid16Count << 8) |
+            ((uint32_t)device.serviceUuid128Count << 16),
+        device.hasManufacturerData ? (uint32_t)device.manufacturerId | 0x10000u : 0,
+        device.hasTxPower ? (uint32_t)(uint8_t)device.txPower | 0x100u : 0
+    };
+    for (uint8_t i = 0; i < 3; i++) {
+        h = (h ^ fields[i]) * 16777619u;
+    }
+    return h ? h : 1;
 }
 
-void ThreatAnalyzer::emitThreatDetection(const WiFiFrameEvent& frame, const char* radio, uint8_t certainty) {
-    ThreatEvent threat;
+void ThreatAnalyzer::buildThreat(const WiFiFrameEvent& frame, const ProximityEstimator::Reading& reading,
+                                 const char* radio, uint8_t certainty, const char* category, ThreatEvent& threat) {
     memset(&threat, 0, sizeof(threat));
     memcpy(threat.mac, frame.mac, 6);
     strncpy(threat.identifier, frame.ssid, sizeof(threat.identifier) - 1);
     threat.rssi = frame.rssi;
+    threat.rssiSmoothed = reading.rssi;
+    threat.trend = reading.trend;
+    threat.distance = reading.band;
     threat.channel = frame.channel;
     threat.radioType = radio;
     threat.certainty = certainty;
-    threat.category = "surveillance_device";
-    
-    EventBus::publishThreat(threat);
+    threat.category = category;
 }
 
-void ThreatAnalyzer::emitThreatDetection(const BluetoothDeviceEvent& device, const char* radio, uint8_t certainty, const char* category) {
-    ThreatEvent threat;
+void ThreatAnalyzer::buildThreat(const BluetoothDeviceEvent& device, const ProximityEstimator::Reading& reading,
+                                 const char* radio, uint8_t certainty, const char* category, ThreatEvent& threat) {
     memset(&threat, 0, sizeof(threat));
     memcpy(threat.mac, device.mac, 6);
     strncpy(threat.identifier, device.name, sizeof(threat.identifier) - 1);
     threat.rssi = device.rssi;
+    threat.rssiSmoothed = reading.rssi;
+    threat.trend = reading.trend;
+    threat.distance = reading.band;
     threat.channel = 0;
     threat.radioType = radio;
     threat.certainty = certainty;
     threat.category = category;
-    
-    EventBus::publishThreat(threat);
 }
 
 // SoundEngine implementation
+// Preloaded at boot when there is PSRAM, most latency-sensitive first.
+static const char* const PRELOADED_CLIPS[] = { "/alert.wav", "/ready.wav", "/startup.wav" };
+
 void SoundEngine::initialize() {
     volumeLevel = DEFAULT_VOLUME;
     
@@ -353,7 +1055,24 @@ void SoundEngine::initialize() {
         return;
     }
     
+    if (clips.begin(LittleFS)) {
+        for (size_t i = 0; i < sizeof(PRELOADED_CLIPS) / sizeof(PRELOADED_CLIPS[0]); i++) {
+            if (!clips.preload(PRELOADED_CLIPS[i])) {
+                Serial.printf("[Audio] Not cached, will stream: %s\n", PRELOADED_CLIPS[i]);
+            }
+        }
+        Serial.printf("[Audio] Cached %u clips, %u KB in PSRAM\n", clips.count(),
+                      (unsigned)(clips.bytesUsed() / 1024));
+    } else {
+        Serial.println("[Audio] No PSRAM, clips stream from flash");
+    }
+    
     setupI2SInterface();
+    requests = xQueueCreate(1, sizeof(const char*));
+    if (!requests || !TaskTopology::start(TaskTopology::AUDIO, audioTask, this)) {
+        Serial.println("[Audio] Failed to start audio task");
+        return;
+    }
     Serial.println("[Audio] Sound system initialized");
 }
 
@@ -391,50 +1110,130 @@ void SoundEngine::setupI2SInterface() {
 }
 
 void SoundEngine::playSound(const char* filename) {
-    File audioFile = LittleFS.open(filename, "r");
-    if (!audioFile) {
-        Serial.printf("[Audio] Cannot open: %s\n", filename);
-        return;
+    if (requests) xQueueOverwrite(requests, &filename);
+}
+
+void SoundEngine::stop() {
+    const char* none = nullptr;
+    if (requests) xQueueOverwrite(requests, &none);
+}
+
+bool SoundEngine::isPlaying() const {
+    return playing;
+}
+
+void SoundEngine::audioTask(void* param) {
+    SoundEngine* engine = (SoundEngine*)param;
+    const char* request;
+    for (;;) {
+        // Sleep on the mailbox when idle; while streaming, only look at it.
+        TickType_t wait = engine->playing ? 0 : portMAX_DELAY;
+        if (xQueueReceive(engine->requests, &request, wait) == pdTRUE) {
+            engine->handleRequest(request);
+        }
+        if (engine->playing) {
+            engine->streamStep();
+        }
+    }
+}
+
+void SoundEngine::handleRequest(const char* filename) {
+    if (filename && playing && strcmp(filename, currentFile) == 0) return;
+    stopPlayback();
+    if (filename) startPlayback(filename);
+}
+
+void SoundEngine::startPlayback(const char* filename) {
+    ClipCache::Clip clip;
+    if (clips.get(filename, clip) && clip.length > WAV_HEADER_BYTES) {
+        clipData = clip.data + WAV_HEADER_BYTES;
+        clipRemaining = clip.length - WAV_HEADER_BYTES;
+    } else {
+        audioFile = LittleFS.open(filename, "r");
+        if (!audioFile) {
+            Serial.printf("[Audio] Cannot open: %s\n", filename);
+            return;
+        }
+        audioFile.seek(WAV_HEADER_BYTES);
+        clipData = nullptr;
     }
     
-    audioFile.seek(44);
-    streamAudioFile(audioFile);
+    gainQ15 = VolumeKernel::toQ15(volumeLevel);
+    for (uint8_t i = 0; i < 2; i++) {
+        chunks[i].length = 0;
+        chunks[i].offset = 0;
+    }
+    front = 0;
+    currentFile = filename;
+    playing = true;
+}
+
+void SoundEngine::stopPlayback() {
+    if (!playing) return;
+    playing = false;
     audioFile.close();
+    clipData = nullptr;
+    currentFile = nullptr;
+    // Drop the rest of the old sound so the new one starts straight away.
+    i2s_zero_dma_buffer(I2S_NUM_0);
 }
 
-void SoundEngine::streamAudioFile(File& audioFile) {
-    uint8_t buffer[512];
-    size_t bytesWritten;
+void SoundEngine::streamStep() {
+    Chunk& current = chunks[front];
+    Chunk& next = chunks[front ^ 1];
+    if (next.length == 0) {
+        fillChunk(next);
+    }
     
-    if (volumeLevel >= 1.0f) {
-        while (audioFile.available()) {
-            size_t bytesRead = audioFile.read(buffer, sizeof(buffer));
-            if (bytesRead > 0) {
-                i2s_write(I2S_NUM_0, buffer, bytesRead, &bytesWritten, portMAX_DELAY);
-                Mini12864DisplayUpdate();
-            }
+    if (current.offset == current.length) {
+        if (next.length == 0) {
+            // End of file; DMA plays out what it holds, then silence.
+            playing = false;
+            audioFile.close();
+            clipData = nullptr;
+            currentFile = nullptr;
+            return;
         }
+        current.length = 0;
+        current.offset = 0;
+        front ^= 1;
+        return;
+    }
+    
+    size_t bytesWritten = 0;
+    i2s_write(I2S_NUM_0, current.data + current.offset, current.length - current.offset,
+              &bytesWritten, pdMS_TO_TICKS(WRITE_WAIT_MS));
+    current.offset += bytesWritten;
+}
+
+bool SoundEngine::fillChunk(Chunk& chunk) {
+    TaskTopology::beginWork(TaskTopology::AUDIO);
+    size_t bytesRead;
+    if (clipData) {
+        bytesRead = clipRemaining < sizeof(chunk.data) ? clipRemaining : sizeof(chunk.data);
+        memcpy(chunk.data, clipData, bytesRead);
+        clipData += bytesRead;
+        clipRemaining -= bytesRead;
     } else {
-        while (audioFile.available()) {
-            size_t bytesRead = audioFile.read(buffer, sizeof(buffer));
-            if (bytesRead == 0) break;
-            
-            size_t sampleCount = (bytesRead / 2) * 2;
-            applyVolumeControl(buffer, sampleCount / 2);
-            i2s_write(I2S_NUM_0, buffer, sampleCount, &bytesWritten, portMAX_DELAY);
-            Mini12864DisplayUpdate();
-        }
+        bytesRead = audioFile.read(chunk.data, sizeof(chunk.data));
     }
+    chunk.length = bytesRead & ~(size_t)1;  // Whole 16-bit samples
+    chunk.offset = 0;
+    if (chunk.length > 0) {
+        applyVolumeControl(chunk.data, chunk.length / 2);
+    }
+    TaskTopology::endWork(TaskTopology::AUDIO);
+    return chunk.length > 0;
 }
 
 void SoundEngine::applyVolumeControl(uint8_t* buffer, size_t sampleCount) {
     int16_t* samples = (int16_t*)buffer;
+    int32_t target = VolumeKernel::toQ15(volumeLevel);
     
-    for (size_t i = 0; i < sampleCount; i++) {
-        int32_t scaled = (int32_t)((int32_t)samples[i] * volumeLevel);
-        if (scaled > 32767) scaled = 32767;
-        if (scaled < -32768) scaled = -32768;
-        samples[i] = (int16_t)scaled;
+    if (gainQ15 != target) {
+        gainQ15 = VolumeKernel::ramp(samples, sampleCount, gainQ15, target, VOLUME_RAMP_STEP_Q15);
+    } else if (gainQ15 != VolumeKernel::UNITY_Q15) {
+        VolumeKernel::scale(samples, sampleCount, gainQ15);
     }
 }
 
@@ -447,16 +1246,21 @@ void TelemetryReporter::initialize() {
     bootTime = millis();
 }
 
-void TelemetryReporter::handleThreatDetection(const ThreatEvent& threat) {
+void TelemetryReporter::handleDevicePresence(const DevicePresenceEvent& event) {
     DynamicJsonDocument doc(2048);
     
-    doc["event"] = "target_detected";
+    switch (event.change) {
+        case DeviceTracker::ENTER: doc["event"] = "device_enter"; break;
+        case DeviceTracker::LEAVE: doc["event"] = "device_leave"; break;
+        default:                   doc["event"] = "device_update"; break;
+    }
     doc["ms_since_boot"] = millis() - bootTime;
     
-    appendSourceInfo(threat, doc);
-    appendTargetIdentity(threat, doc);
-    appendIndicators(threat, doc);
-    appendMetadata(threat, doc);
+    appendSourceInfo(event.threat, doc);
+    appendTargetIdentity(event.threat, doc);
+    appendIndicators(event.threat, doc);
+    appendMetadata(event.threat, doc);
+    appendPresence(event, doc);
     
     outputJSON(doc);
 }
@@ -466,6 +1270,9 @@ void TelemetryReporter::appendSourceInfo(const ThreatEvent& threat, JsonDocument
     source["radio"] = threat.radioType;
     source["channel"] = threat.channel;
     source["rssi"] = threat.rssi;
+    source["rssi_smoothed"] = threat.rssiSmoothed;
+    source["trend"] = ProximityEstimator::trendName(threat.trend);
+    source["distance"] = ProximityEstimator::bandName(threat.distance);
 }
 
 void TelemetryReporter::appendTargetIdentity(const ThreatEvent& threat, JsonDocument& doc) {
@@ -507,11 +1314,134 @@ void TelemetryReporter::appendMetadata(const ThreatEvent& threat, JsonDocument&
     metadata["detection_method"] = "combined_signature";
 }
 
+void TelemetryReporter::appendPresence(const DevicePresenceEvent& event, JsonDocument& doc) {
+    const TrackedDevice& device = event.device;
+    JsonObject presence = doc.createNestedObject("presence");
+    
+    presence["session_start_ms"] = device.sessionStartMs - bootTime;
+    presence["last_seen_ms"] = device.lastSeenMs - bootTime;
+    presence["duration_ms"] = device.sessionDurationMs();
+    presence["sightings"] = device.sightings;
+    presence["total_sightings"] = device.totalSightings;
+    presence["sessions"] = device.sessions;
+    presence["rssi_avg"] = device.rssiAverage();
+    presence["rssi_min"] = device.rssiMin;
+    presence["rssi_max"] = device.rssiMax;
+    
+    JsonArray radios = presence.createNestedArray("radios");
+    if (device.radios & DeviceTracker::RADIO_WIFI) radios.add("wifi");
+    if (device.radios & DeviceTracker::RADIO_BLE) radios.add("bluetooth");
+    
+    JsonArray channels = presence.createNestedArray("channels");
+    for (uint8_t channel = 1; channel < 16; channel++) {
+        if (device.channelMask & (1u << channel)) channels.add(channel);
+    }
+    
+    presence["alerts"] = event.alertsRaised;
+    presence["alerts_suppressed"] = event.alertsSuppressed;
+    presence["devices_present"] = event.presentCount;
+}
+
 void TelemetryReporter::outputJSON(const JsonDocument& doc) {
     serializeJson(doc, Serial);
     Serial.println();
 }
 
+// Threat fan-out (see src/TaskTopology.h). The analysis task only posts
+// threats to the EventBus, and the dispatcher task queues them here. The
+// telemetry task tracks devices, publishes presence changes (written out by
+// the dispatcher) and passes the sightings the AlertPolicy approves on to
+// loop(), the render task, for alert UI/audio.
+static const UBaseType_t THREAT_QUEUE_DEPTH = 8;
+QueueHandle_t telemetryQueue = nullptr;
+QueueHandle_t alertQueue = nullptr;
+// Threats lost to a full queue. Each has one writer: the dispatcher task for
+// telemetryQueue, the telemetry task for alertQueue.
+volatile uint32_t telemetryQueueDrops = 0;
+volatile uint32_t alertQueueDrops = 0;
+
+uint32_t getTelemetryQueueDrops() {
+    return telemetryQueueDrops;
+}
+
+uint32_t getAlertQueueDrops() {
+    return alertQueueDrops;
+}
+
+// Device presence (see src/DeviceTracker.h). The tracker belongs to the
+// telemetry task, which folds per-frame threats into enter/update/leave
+// events. lastThreat holds the latest detection for each tracker entry; the
+// alert policy keeps its per-device state under the same index.
+static const uint32_t PRESENCE_POLL_MS = 1000;
+DeviceTracker deviceTracker;
+AlertPolicy alertPolicy;
+ThreatEvent lastThreat[DeviceTracker::CAPACITY];
+
+void publishPresence(DeviceTracker::Change change, const TrackedDevice& device,
+                     const ThreatEvent& threat, uint8_t index) {
+    const DeviceAlertState& alerts = alertPolicy.getDeviceState(index);
+    DevicePresenceEvent event;
+    event.change = change;
+    event.threat = threat;
+    event.device = device;
+    event.presentCount = deviceTracker.getStats().present;
+    event.alertsRaised = alerts.raised;
+    event.alertsSuppressed = alerts.suppressed;
+    EventBus::publishDevicePresence(event);
+}
+
+void trackThreat(const ThreatEvent& threat) {
+    uint8_t radio = strcmp(threat.radioType, "wifi") == 0 ? DeviceTracker::RADIO_WIFI : DeviceTracker::RADIO_BLE;
+    DeviceTracker::Observation observation;
+    uint32_t nowMs = millis();
+    deviceTracker.observe(threat.mac, threat.rssi, threat.channel, radio, nowMs, observation);
+    if (observation.evictedPresent) {
+        publishPresence(DeviceTracker::LEAVE, observation.evicted, lastThreat[observation.index], observation.index);
+    }
+    lastThreat[observation.index] = threat;
+    
+    AlertPolicy::Verdict verdict = alertPolicy.evaluate(observation.index, observation.change == DeviceTracker::ENTER,
+                                                        threat.certainty, observation.device->rssiAverage(), nowMs);
+    if (verdict != AlertPolicy::SUPPRESS) {
+        if (xQueueSend(alertQueue, &threat, 0) != pdTRUE) {
+            alertQueueDrops = alertQueueDrops + 1;
+        }
+    }
+    if (observation.change != DeviceTracker::NONE) {
+        publishPresence(observation.change, *observation.device, threat, observation.index);
+    }
+}
+
+void expirePresence() {
+    DeviceTracker::Observation observation;
+    while (deviceTracker.expireNext(millis(), observation)) {
+        publishPresence(DeviceTracker::LEAVE, *observation.device, lastThreat[observation.index], observation.index);
+    }
+}
+
+void telemetryTask(void* param) {
+    ThreatEvent threat;
+    for (;;) {
+        bool haveThreat = xQueueReceive(telemetryQueue, &threat, pdMS_TO_TICKS(PRESENCE_POLL_MS)) == pdTRUE;
+        TaskTopology::beginWork(TaskTopology::TELEMETRY);
+        if (haveThreat) {
+            trackThreat(threat);
+        }
+        expirePresence();
+        TaskTopology::endWork(TaskTopology::TELEMETRY);
+    }
+}
+
+void startPipelineTasks() {
+    telemetryQueue = xQueueCreate(THREAT_QUEUE_DEPTH, sizeof(ThreatEvent));
+    alertQueue = xQueueCreate(THREAT_QUEUE_DEPTH, sizeof(ThreatEvent));
+    if (!EventBus::startDispatcher()) {
+        Serial.println("[EventBus] Failed to start dispatcher, delivering all events synchronously");
+    }
+    TaskTopology::start(TaskTopology::TELEMETRY, telemetryTask, nullptr);
+    TaskTopology::adoptCurrentTask(TaskTopology::RENDER);
+}
+
 // Main system initialization
 void setup() {
     Serial.begin(115200);
@@ -524,21 +1454,27 @@ void setup() {
     audioSystem.initialize();
     audioSystem.playSound("/startup.wav");
     
+    EventBus::subscribeWifiFrames([](const WiFiFrameEvent* frames, size_t count) {
+        threatEngine.analyzeWiFiFrames(frames, count);
+    });
+    
+    EventBus::subscribeBluetoothDevices([](const BluetoothDeviceEvent* devices, size_t count) {
+        threatEngine.analyzeBluetoothDevices(devices, count);
+    });
+    
     EventBus::subscribeWifiFrame([](const WiFiFrameEvent& event) {
-        threatEngine.analyzeWiFiFrame(event);
         Mini12864DisplayNotifyWifiFrame(event.mac, event.channel, event.rssi);
     });
     
-    EventBus::subscribeBluetoothDevice([](const BluetoothDeviceEvent& event) {
-        threatEngine.analyzeBluetoothDevice(event);
+    EventBus::subscribeDevicePresence([](const DevicePresenceEvent& event) {
+        reporter.handleDevicePresence(event);
     });
     
+    EventBus::subscribeThreat(RadioScannerManager::noteThreat);
     EventBus::subscribeThreat([](const ThreatEvent& event) {
-        reporter.handleThreatDetection(event);
-        Mini12864DisplayShowAlert();
-        AudioEvent audioEvent;
-        audioEvent.soundFile = "/alert.wav";
-        EventBus::publishAudioRequest(audioEvent);
+        if (xQueueSend(telemetryQueue, &event, 0) != pdTRUE) {
+            telemetryQueueDrops = telemetryQueueDrops + 1;
+        }
     });
     
     EventBus::subscribeAudioRequest([](const AudioEvent& event) {
@@ -549,18 +1485,112 @@ void setup() {
     Mini12864DisplayNotifySystemReady();
         audioSystem.playSound("/ready.wav");
     });
+
+    // Subscribers to these run on the dispatcher task, so a slow one (serial
+    // output, display updates) never holds up analysis or device tracking.
+    EventBus::setDelivery(EventType::ThreatIdentified, EventBus::ASYNC);
+    EventBus::setDelivery(EventType::DevicePresenceChanged, EventBus::ASYNC);
+    EventBus::setDelivery(EventType::WifiFrameCaptured, EventBus::ASYNC);
+    EventBus::setDelivery(EventType::BluetoothDeviceFound, EventBus::ASYNC);
     
+    startPipelineTasks();
     threatEngine.initialize();
+    const char* signatureError = nullptr;
+    if (threatEngine.loadSignatureFile(LittleFS, ThreatAnalyzer::SIGNATURE_FILE, &signatureError)) {
+        Serial.println("[Analyzer] Signature database loaded");
+    } else if (signatureError) {
+        Serial.printf("[Analyzer] Signature database rejected (%s), using built-in signatures\n", signatureError);
+    }
+    const char* listError = nullptr;
+    if (threatEngine.loadDeviceLists(LittleFS, ThreatAnalyzer::DEVICE_LIST_FILE, &listError)) {
+        Serial.printf("[Analyzer] Device lists loaded (%u allowed, %u watched)\n",
+                      (unsigned)threatEngine.getDeviceListSize(ThreatAnalyzer::ALLOWLIST),
+                      (unsigned)threatEngine.getDeviceListSize(ThreatAnalyzer::WATCHLIST));
+    } else if (listError) {
+        Serial.printf("[Analyzer] Device lists rejected (%s), starting empty\n", listError);
+    }
     reporter.initialize();
     rfScanner.initialize();
     
+    Serial.printf("[System] Free heap after boot: %u bytes, largest block %u\n",
+                  ESP.getFreeHeap(), ESP.getMaxAllocHeap());
     Serial.println("System operational - scanning for targets");
     Serial.println();
     
     EventBus::publishSystemReady();
 }
 
+// Serial console for the device lists, one command per line:
+//   allow|unallow|watch|unwatch AA:BB:CC:DD:EE:FF
+// Each change is saved straight away so it survives a reboot.
+static char listCommand[48];
+static size_t listCommandLength = 0;
+
+static void runListCommand(const char* line) {
+    char verb[12];
+    unsigned int octets[6];
+    if (sscanf(line, "%11s %x:%x:%x:%x:%x:%x", verb, &octets[0], &octets[1], &octets[2],
+               &octets[3], &octets[4], &octets[5]) != 7) {
+        return;
+    }
+    uint8_t mac[6];
+    for (int i = 0; i < 6; i++) mac[i] = (uint8_t)octets[i];
+    
+    bool ok;
+    ThreatAnalyzer::DeviceList list;
+    if (strcmp(verb, "allow") == 0) {
+        list = ThreatAnalyzer::ALLOWLIST;
+        ok = threatEngine.addToDeviceList(list, mac);
+    } else if (strcmp(verb, "unallow") == 0) {
+        list = ThreatAnalyzer::ALLOWLIST;
+        ok = threatEngine.removeFromDeviceList(list, mac);
+    } else if (strcmp(verb, "watch") == 0) {
+        list = ThreatAnalyzer::WATCHLIST;
+        ok = threatEngine.addToDeviceList(list, mac);
+    } else if (strcmp(verb, "unwatch") == 0) {
+        list = ThreatAnalyzer::WATCHLIST;
+        ok = threatEngine.removeFromDeviceList(list, mac);
+    } else {
+        return;
+    }
+    
+    if (ok && !threatEngine.saveDeviceLists(LittleFS, ThreatAnalyzer::DEVICE_LIST_FILE)) {
+        Serial.println("[Analyzer] Device lists could not be saved");
+    }
+    Serial.printf("[Analyzer] %s %s (%u on list)\n", verb, ok ? "ok" : "failed",
+                  (unsigned)threatEngine.getDeviceListSize(list));
+}
+
+static void pollListCommands() {
+    while (Serial.available() > 0) {
+        int c = Serial.read();
+        if (c == '\r') continue;
+        if (c != '\n') {
+            if (listCommandLength < sizeof(listCommand) - 1) listCommand[listCommandLength++] = (char)c;
+            continue;
+        }
+        listCommand[listCommandLength] = '\0';
+        listCommandLength = 0;
+        runListCommand(listCommand);
+    }
+}
+
 void loop() {
+    TaskTopology::beginWork(TaskTopology::RENDER);
+    pollListCommands();
+    
+    ThreatEvent threat;
+    bool alert = false;
+    while (xQueueReceive(alertQueue, &threat, 0) == pdTRUE) {
+        alert = true;
+    }
+    if (alert) {
+        Mini12864DisplayShowAlert();
+        AudioEvent audioEvent;
+        audioEvent.soundFile = "/alert.wav";
+        EventBus::publishAudioRequest(audioEvent);
+    }
+    
     Mini12864DisplayUpdate();
     float newVolume = 0.0f;
     if (Mini12864DisplayConsumeVolume(&newVolume)) {
@@ -573,4 +1603,5 @@ void loop() {
         EventBus::publishAudioRequest(audioEvent);
     }
     rfScanner.update();
+    TaskTopology::endWork(TaskTopology::RENDER);
 }
\ No newline at end of file
@@ -0,0 +1,63 @@
+#ifndef ALERT_POLICY_H
+#define ALERT_POLICY_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "DeviceTracker.h"
+
+struct AlertPolicyStats {
+    uint32_t alerts;                // New-session and reminder alerts raised
+    uint32_t escalations;           // Alerts raised because a device got closer or more certain
+    uint32_t suppressedCooldown;    // Held back by the per-device cooldown
+    uint32_t suppressedRateCap;     // Held back by the global rate cap
+};
+
+// Per-device alert counts for the current presence session.
+struct DeviceAlertState {
+    uint32_t lastAlertMs;
+    uint16_t raised;
+    uint16_t suppressed;
+    uint8_t certainty;              // At the last alert
+    int8_t rssi;                    // Average RSSI at the last alert
+    bool armed;                     // Next sighting alerts (new session, or held by the rate cap)
+};
+
+// Decides which sightings reach the user-facing sinks (sound, buzzer, alert
+// screen). A device alerts once when its presence session opens, then stays
+// quiet for COOLDOWN_MS unless its certainty or average RSSI has risen enough
+// since its last alert to count as an escalation. A token bucket caps alerts
+// across all devices. An alert held back by the cap stays armed and goes out
+// on a later sighting. State is indexed by DeviceTracker entry, and a new
+// session re-arms the entry, so a device that leaves and returns alerts
+// again. Owned by the same task as the tracker.
+class AlertPolicy {
+public:
+    static const uint32_t COOLDOWN_MS = 60000;          // Reminder interval while present
+    static const uint32_t MIN_ESCALATION_GAP_MS = 3000;
+    static const uint8_t CERTAINTY_STEP = 10;           // Rise that counts as an escalation
+    static const uint8_t RSSI_STEP_DB = 10;
+    static const uint32_t RATE_INTERVAL_MS = 5000;      // Sustained rate: one alert per interval
+    static const uint8_t RATE_BURST = 3;                // Alerts allowed back to back
+
+    enum Verdict { SUPPRESS, ALERT, ESCALATE };
+
+    AlertPolicy();
+
+    void clear();
+
+    // `newSession` is true when the tracker reported ENTER for this sighting.
+    Verdict evaluate(uint8_t index, bool newSession, uint8_t certainty, int8_t rssi, uint32_t nowMs);
+
+    const DeviceAlertState& getDeviceState(uint8_t index) const { return devices[index]; }
+    const AlertPolicyStats& getStats() const { return stats; }
+
+private:
+    DeviceAlertState devices[DeviceTracker::CAPACITY];
+    AlertPolicyStats stats;
+    uint32_t rateCreditMs;
+    uint32_t lastRefillMs;
+
+    bool takeRateToken(uint32_t nowMs);
+};
+
+#endif
@@ -0,0 +1,86 @@
+#ifndef FRAME_RING_H
+#define FRAME_RING_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+// Fixed-capacity lock-free ring for exactly one producer and one consumer.
+// The producer only writes `head` and the consumer only writes `tail`, so a
+// push or pop is a copy plus one release store. Capacity must be a power of two.
+template <typename T, size_t Capacity>
+class FrameRing {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "FrameRing capacity must be a power of two");
+
+public:
+    FrameRing() : head(0), tail(0), pushedCount(0), droppedCount(0), highWater(0) {}
+
+    // Producer side. Returns false (and counts the drop) when the ring is full.
+    bool push(const T& item) {
+        uint32_t h = head.load(std::memory_order_relaxed);
+        uint32_t used = h - tail.load(std::memory_order_acquire);
+        if (used >= Capacity) {
+            droppedCount.store(droppedCount.load(std::memory_order_relaxed) + 1,
+                               std::memory_order_relaxed);
+            return false;
+        }
+
+        slots[h & (Capacity - 1)] = item;
+        head.store(h + 1, std::memory_order_release);
+
+        pushedCount.store(pushedCount.load(std::memory_order_relaxed) + 1,
+                          std::memory_order_relaxed);
+        if (used + 1 > highWater.load(std::memory_order_relaxed)) {
+            highWater.store(used + 1, std::memory_order_relaxed);
+        }
+        return true;
+    }
+
+    // Consumer side. Returns false when the ring is empty.
+    bool pop(T& out) {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        out = slots[t & (Capacity - 1)];
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. Copies up to `maxCount` items into `out` with a single
+    // release store and returns how many were taken.
+    size_t popBatch(T* out, size_t maxCount) {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        uint32_t available = head.load(std::memory_order_acquire) - t;
+        size_t count = available < maxCount ? available : maxCount;
+        for (size_t i = 0; i < count; i++) {
+            out[i] = slots[(t + i) & (Capacity - 1)];
+        }
+        tail.store(t + (uint32_t)count, std::memory_order_release);
+        return count;
+    }
+
+    size_t size() const {
+        return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+    }
+
+    static constexpr size_t capacity() { return Capacity; }
+
+    uint32_t getPushedCount() const { return pushedCount.load(std::memory_order_relaxed); }
+    uint32_t getDroppedCount() const { return droppedCount.load(std::memory_order_relaxed); }
+    uint32_t getHighWater() const { return highWater.load(std::memory_order_relaxed); }
+
+private:
+    T slots[Capacity];
+    std::atomic<uint32_t> head;
+    std::atomic<uint32_t> tail;
+
+    // Written by the producer only; read from anywhere for diagnostics.
+    std::atomic<uint32_t> pushedCount;
+    std::atomic<uint32_t> droppedCount;
+    std::atomic<uint32_t> highWater;
+};
+
+#endif
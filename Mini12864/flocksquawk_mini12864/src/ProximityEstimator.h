@@ -0,0 +1,80 @@
+#ifndef PROXIMITY_ESTIMATOR_H
+#define PROXIMITY_ESTIMATOR_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Per-device RSSI tracking. Each device keeps two exponential averages of
+// its signal level, with time constants of FAST_TAU_MS and SLOW_TAU_MS, so
+// the smoothing is the same however often the device is heard. The fast
+// one is the smoothed RSSI. On a steady ramp the slow one lags further
+// behind, so the gap between them divided by the difference in time
+// constants is the rate of change: a single multipath spike barely moves
+// it, while a sustained walk or drive does. All math is integer fixed
+// point, which keeps it off the float path on the S2.
+//
+// The rate gives the trend, with hysteresis so a steady device does not
+// flicker between trends. The smoothed level gives a coarse distance band,
+// assuming about -45 dBm at 1 m and a path-loss exponent of 2.5:
+//   IMMEDIATE  >= -60 dBm   under ~4 m
+//   NEAR       >= -72 dBm   ~4-12 m
+//   FAR        >= -84 dBm   ~12-35 m
+//   REMOTE     below that
+// Transmit power varies by device, so bands compare one device over time
+// better than they compare two devices.
+//
+// Devices live in a 4-way set-associative table that replaces the least
+// recently seen entry, so update() is constant time. Not thread-safe; the
+// analysis task owns it.
+class ProximityEstimator {
+public:
+    static const uint8_t CAPACITY = 64;
+    static const uint8_t WAYS = 4;
+
+    enum Trend : uint8_t { STEADY, APPROACHING, DEPARTING };
+    enum Band : uint8_t { IMMEDIATE, NEAR, FAR, REMOTE };
+
+    struct Reading {
+        int8_t rssi;            // Smoothed, dBm
+        int16_t rateQ8;         // dB/s in Q8, positive = getting stronger
+        Trend trend;
+        Band band;
+    };
+
+    static const uint32_t FAST_TAU_MS = 2000;
+    static const uint32_t SLOW_TAU_MS = 8000;
+    static const int16_t TREND_ENTER_Q8 = 128;      // 0.5 dB/s
+    static const int16_t TREND_EXIT_Q8 = 64;        // 0.25 dB/s
+    static const uint8_t TREND_MIN_SAMPLES = 8;
+    static const uint32_t RESET_GAP_MS = 60000;     // Longer silences start the device over
+
+    static const int8_t BAND_IMMEDIATE_DBM = -60;
+    static const int8_t BAND_NEAR_DBM = -72;
+    static const int8_t BAND_FAR_DBM = -84;
+
+    ProximityEstimator();
+
+    void clear();
+    Reading update(const uint8_t* mac, int8_t rssi, uint32_t nowMs);
+
+    static Band bandFor(int8_t rssi);
+    static const char* trendName(Trend trend);
+    static const char* bandName(Band band);
+
+private:
+    struct Entry {
+        uint8_t mac[6];
+        bool used;
+        uint8_t samples;
+        Trend trend;
+        int16_t fastQ8;         // dBm, Q8
+        int16_t slowQ8;
+        uint32_t lastMs;
+    };
+
+    Entry entries[CAPACITY];
+
+    Entry& findEntry(const uint8_t* mac, bool& fresh);
+};
+
+#endif
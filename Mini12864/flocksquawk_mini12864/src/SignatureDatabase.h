@@ -0,0 +1,113 @@
+#ifndef SIGNATURE_DATABASE_H
+#define SIGNATURE_DATABASE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "OuiTable.h"
+#include "NameMatcher.h"
+#include "UuidSet.h"
+
+// Per-signature metadata. `weight` is the certainty (0-100) a match on this
+// signature carries on its own.
+struct SignatureInfo {
+    uint8_t weight;
+    uint8_t category;
+};
+
+// One complete set of detection tables. Every member is a view, so a set can
+// point at the compiled-in DeviceProfiles or into a loaded database image.
+struct SignatureSet {
+    enum Kind { MAC_PREFIX, NETWORK_NAME, BLE_NAME, SERVICE_UUID, KIND_COUNT };
+
+    // Category ids map to fixed strings, so a ThreatEvent never points into
+    // an image that a later reload frees.
+    enum Category { SURVEILLANCE_DEVICE, ACOUSTIC_DETECTOR, CATEGORY_COUNT };
+
+    OuiTable macPrefixes;
+    NameMatcher networkNames;
+    NameMatcher bleNames;
+    UuidSet services;
+    const SignatureInfo* info[KIND_COUNT];  // Parallel to each table; null = defaults
+    uint32_t revision;                      // 0 for the compiled-in set
+
+    SignatureSet() : info(), revision(0) {}
+
+    size_t count(Kind kind) const;
+    SignatureInfo getInfo(Kind kind, int index) const;
+
+    static SignatureInfo defaultInfo(Kind kind);
+    static const char* categoryName(uint8_t category);
+};
+
+// On-flash layout, all little-endian:
+//
+//   SignatureFileHeader
+//   SignatureSectionEntry[sectionCount]
+//   section payloads, each starting on a 4-byte boundary
+//
+// OUI        uint32_t[n], sorted ascending
+// NAMES      uint16_t stateCount, classCount, patternCount, reserved
+//            uint8_t  charClass[256]
+//            uint16_t transitions[stateCount * classCount]
+//            uint16_t firstPattern[stateCount], outputLink[stateCount]
+//            uint16_t nextPattern[patternCount]
+// UUIDS      uint16_t entryCount, slotMask; uint32_t reserved
+//            Uuid128  entries[entryCount]
+//            uint16_t aliasSlots[slotMask + 1], fullSlots[slotMask + 1]
+// *_INFO     SignatureInfo[n], parallel to the matching table
+//
+// Every section is optional; a missing table matches nothing and a missing
+// info section falls back to SignatureSet::defaultInfo(). Unknown section
+// types are skipped so newer files still load on older firmware.
+struct SignatureFileHeader {
+    uint32_t magic;
+    uint16_t formatVersion;
+    uint16_t sectionCount;
+    uint32_t revision;             // Bumped for every published database
+    uint32_t totalLength;          // Whole file, header included
+    uint32_t crc32;                // CRC-32 (IEEE) of every byte after the header
+    uint32_t reserved;
+};
+
+struct SignatureSectionEntry {
+    uint16_t type;
+    uint16_t reserved;
+    uint32_t offset;               // From the start of the file
+    uint32_t length;
+};
+
+static_assert(sizeof(SignatureInfo) == 2, "SignatureInfo is part of the file format");
+static_assert(sizeof(SignatureFileHeader) == 24, "SignatureFileHeader is part of the file format");
+static_assert(sizeof(SignatureSectionEntry) == 12, "SignatureSectionEntry is part of the file format");
+
+class SignatureDatabase {
+public:
+    static const uint32_t MAGIC = 0x47495346;  // "FSIG"
+    static const uint16_t FORMAT_VERSION = 1;
+
+    enum SectionType {
+        SECTION_OUI = 1,
+        SECTION_NETWORK_NAMES = 2,
+        SECTION_BLE_NAMES = 3,
+        SECTION_SERVICE_UUIDS = 4,
+        SECTION_OUI_INFO = 5,
+        SECTION_NETWORK_NAME_INFO = 6,
+        SECTION_BLE_NAME_INFO = 7,
+        SECTION_SERVICE_UUID_INFO = 8
+    };
+
+    // Validates `image` (4-byte aligned) and points `out` into it; nothing is
+    // copied or allocated, so the image must outlive the set. Every index in
+    // the tables is bounds-checked, so a file that passes cannot make a
+    // lookup read out of range or loop forever. On failure `error` names the
+    // first problem found.
+    static bool parse(const uint8_t* image, size_t length, SignatureSet& out, const char** error);
+
+    static uint32_t crc32(const uint8_t* data, size_t length, uint32_t crc = 0);
+
+private:
+    static bool parseNames(const uint8_t* data, size_t length, NameMatcher& out);
+    static bool parseUuids(const uint8_t* data, size_t length, UuidSet& out);
+};
+
+#endif
@@ -5,26 +5,71 @@
 #include <driver/i2s.h>
 #include <FS.h>
 #include <LittleFS.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
 #include "EventBus.h"
+#include "ClipCache.h"
+#include "VolumeKernel.h"
 
+// WAV playback on its own task (TaskTopology::AUDIO), which owns the I2S
+// driver. playSound() and stop() only leave a request in a one-slot mailbox
+// and return, so callers never wait on flash or I2S. The latest request
+// wins: a new sound cuts off the one playing and flushes what is left of it
+// in DMA, except a repeat of the sound already playing, which carries on.
+//
+// Sounds stream through two chunk buffers. The next chunk is copied from
+// the clip cache, or read from LittleFS for a clip that is not cached, and
+// volume-scaled while the current one waits for DMA space. Each I2S write
+// gives up after WRITE_WAIT_MS so a new request is seen promptly. Volume is
+// applied in Q15 fixed point (VolumeKernel.h), and a change fades in over
+// about 64 ms rather than clicking.
 class SoundEngine {
 public:
     static const uint8_t PIN_BCLK = 27;
     static const uint8_t PIN_LRC = 26;
     static const uint8_t PIN_DATA = 25;
     static constexpr float DEFAULT_VOLUME = 0.4f;
+    static const size_t CHUNK_BYTES = 1024;
+    static const uint32_t WRITE_WAIT_MS = 20;
+    static const size_t WAV_HEADER_BYTES = 44;
+    static const int32_t VOLUME_RAMP_STEP_Q15 = 64;    // Per sample pair, 0 = change at once
 
     void initialize();
     void setVolume(float level);
     void playSound(const char* filename);
+    void stop();
+    bool isPlaying() const;
     void handleAudioRequest(const AudioEvent& event);
     
 private:
-    float volumeLevel;
+    struct Chunk {
+        uint8_t data[CHUNK_BYTES];
+        size_t length;
+        size_t offset;          // Bytes already handed to I2S
+    };
+
+    volatile float volumeLevel;
+    QueueHandle_t requests;     // const char*, nullptr = stop
+    volatile bool playing;
+
+    // Audio task only, after initialize()
+    ClipCache clips;
+    const uint8_t* clipData;    // Next sample of a cached clip, nullptr = read audioFile
+    size_t clipRemaining;
+    File audioFile;
+    const char* currentFile;
+    Chunk chunks[2];
+    uint8_t front;
+    int32_t gainQ15;            // Gain the last chunk ended on
     
+    static void audioTask(void* param);
     void setupI2SInterface();
-    void streamAudioFile(File& audioFile);
+    void handleRequest(const char* filename);
+    void startPlayback(const char* filename);
+    void stopPlayback();
+    void streamStep();
+    bool fillChunk(Chunk& chunk);
     void applyVolumeControl(uint8_t* buffer, size_t sampleCount);
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,79 @@
+#ifndef TASK_TOPOLOGY_H
+#define TASK_TOPOLOGY_H
+
+#include <Arduino.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+// Where the pipeline runs:
+//
+//   core 0  WiFi driver callback  -> CaptureFilter -> WiFi frame ring
+//           NimBLE host callback  -> BLE event ring
+//           esp_timer task        -> channel hops
+//   core 1  analysis  (prio 3)    rings -> ThreatAnalyzer -> EventBus queues
+//           dispatch  (prio 2)    EventBus queues -> async subscribers
+//           telemetry (prio 2)    threat queue -> DeviceTracker -> AlertPolicy
+//           audio     (prio 2)    play requests -> LittleFS -> I2S (I2S builds only)
+//           render    (prio 1)    loop(): display, input, alert queue -> UI/audio
+//
+// Capture placement is the ESP-IDF default for the WiFi and NimBLE host tasks.
+// Render is Arduino's loopTask (pinned by ARDUINO_RUNNING_CORE), so it is
+// adopted rather than created. Single-core chips (ESP32-S2) run it all on 0.
+class TaskTopology {
+public:
+    enum TaskId {
+        ANALYSIS = 0,
+        DISPATCH,
+        TELEMETRY,
+        AUDIO,
+        RENDER,
+        TASK_COUNT
+    };
+
+    struct TaskConfig {
+        const char* name;
+        uint32_t stackSize;     // Bytes
+        UBaseType_t priority;
+        BaseType_t core;
+    };
+
+    struct TaskStats {
+        const char* name;
+        BaseType_t core;
+        UBaseType_t priority;
+        uint64_t busyUs;        // Time between beginWork() and endWork()
+        uint32_t workItems;
+        uint8_t loadPercent;    // busyUs as a share of time since resetStats()
+        uint32_t stackFree;     // Stack high-water mark in bytes, 0 if not running
+    };
+
+    static const BaseType_t CAPTURE_CORE = 0;
+    static const BaseType_t PIPELINE_CORE = 1;
+
+    // Edit before the task is started to change its stack, priority or core.
+    static TaskConfig& config(TaskId id);
+    static bool start(TaskId id, TaskFunction_t entry, void* param);
+    // Registers the calling task under `id` and applies the configured priority.
+    static void adoptCurrentTask(TaskId id);
+    static TaskHandle_t handle(TaskId id);
+
+    // Bracket each unit of work so its CPU time is charged to the task.
+    static void beginWork(TaskId id);
+    static void endWork(TaskId id);
+
+    static TaskStats getStats(TaskId id);
+    static void resetStats();
+
+private:
+    static TaskConfig configs[TASK_COUNT];
+    static TaskHandle_t handles[TASK_COUNT];
+    static int64_t workStartUs[TASK_COUNT];
+    static uint64_t busyUs[TASK_COUNT];
+    static uint32_t workItems[TASK_COUNT];
+    static int64_t statsSinceUs;
+    static portMUX_TYPE statsMux;
+
+    static BaseType_t resolveCore(BaseType_t core);
+};
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef VERDICT_CACHE_H
+#define VERDICT_CACHE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Matcher results for one WiFi frame: signature indices, or -1 for no match.
+struct WiFiVerdict {
+    int32_t nameIndex;
+    int32_t macIndex;
+};
+
+struct VerdictCacheStats {
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t expired;           // Misses on an entry older than the TTL
+    uint32_t replaced;          // Stores that displaced a live entry for another key
+    uint32_t invalidations;     // clear() calls, e.g. on a signature swap
+};
+
+// Direct-mapped cache of WiFi matcher results. An AP repeats the same BSSID
+// and SSID in every beacon, so after the first frame the OUI search and name
+// automaton can be skipped for the TTL. The key is the full MAC plus a
+// word-at-a-time hash of the SSID: the matchers read nothing else, so no
+// other IE goes into it. Entries cache signature indices rather than
+// certainty, which keeps scoring out of the cache, and are only valid for
+// the signature set they were computed against, so the owner must clear()
+// on every swap. Not thread-safe; the analysis task owns it.
+class VerdictCache {
+public:
+    static const size_t CAPACITY = 256;             // Power of two
+    static const uint32_t DEFAULT_TTL_MS = 30000;
+
+    struct Key {
+        uint8_t mac[6];
+        uint8_t ssidLength;
+        uint32_t ssidHash;
+        uint32_t slot;
+    };
+
+    VerdictCache();
+
+    static Key makeKey(const uint8_t* mac, const char* ssid, size_t ssidLength);
+
+    bool lookup(const Key& key, uint32_t nowMs, WiFiVerdict& out);
+    void store(const Key& key, uint32_t nowMs, const WiFiVerdict& verdict);
+    void clear();
+
+    // 0 disables the cache: every lookup misses and nothing is stored.
+    void setTtl(uint32_t ttlMs) { this->ttlMs = ttlMs; }
+    uint32_t getTtl() const { return ttlMs; }
+    const VerdictCacheStats& getStats() const { return stats; }
+
+private:
+    struct Entry {
+        uint8_t mac[6];
+        uint8_t ssidLength;
+        bool valid;
+        uint32_t ssidHash;
+        uint32_t storedMs;
+        WiFiVerdict verdict;
+    };
+
+    Entry entries[CAPACITY];
+    uint32_t ttlMs;
+    VerdictCacheStats stats;
+};
+
+#endif
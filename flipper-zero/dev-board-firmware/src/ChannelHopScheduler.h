@@ -0,0 +1,108 @@
+#ifndef CHANNEL_HOP_SCHEDULER_H
+#define CHANNEL_HOP_SCHEDULER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+struct ChannelHop {
+    uint8_t channel;
+    uint16_t dwellMs;
+};
+
+struct ChannelPlanEntry {
+    uint8_t channel;
+    uint8_t weight;         // Relative share of visits
+    uint16_t dwellMs;       // Dwell used on the next visit
+    uint32_t framesSeen;
+    uint32_t matches;
+    uint32_t lastMatchMs;   // 0 if never matched
+    uint32_t lastVisitMs;
+};
+
+// Decides which WiFi channel to listen on next and for how long.
+// next() is called by the hopper; recordFrame() from the capture callback and
+// recordMatch() from the analysis path, so implementations must tolerate
+// those being called concurrently with next().
+class ChannelHopScheduler {
+public:
+    static const uint8_t MAX_CHANNELS = 14;
+
+    virtual ~ChannelHopScheduler() {}
+    virtual ChannelHop next(uint32_t nowMs) = 0;
+    virtual void recordFrame(uint8_t channel) = 0;
+    virtual void recordMatch(uint8_t channel, uint32_t nowMs) = 0;
+    // Fills `out` with one entry per channel as of nowMs; returns the number
+    // written.
+    virtual size_t getPlan(ChannelPlanEntry* out, size_t maxEntries, uint32_t nowMs) const = 0;
+};
+
+// Fixed-dwell 1..N rotation (the original behaviour).
+class RoundRobinHopScheduler : public ChannelHopScheduler {
+public:
+    RoundRobinHopScheduler(uint8_t channelCount, uint16_t dwellMs);
+
+    ChannelHop next(uint32_t nowMs) override;
+    void recordFrame(uint8_t channel) override;
+    void recordMatch(uint8_t channel, uint32_t nowMs) override;
+    size_t getPlan(ChannelPlanEntry* out, size_t maxEntries, uint32_t nowMs) const override;
+
+private:
+    uint8_t channelCount;
+    uint16_t dwellMs;
+    uint8_t current;
+    uint32_t framesSeen[MAX_CHANNELS + 1];
+    uint32_t matches[MAX_CHANNELS + 1];
+    uint32_t lastMatchMs[MAX_CHANNELS + 1];
+    uint32_t lastVisitMs[MAX_CHANNELS + 1];
+};
+
+// Yield-weighted hopper. Each channel gets a weight from a base share, a bonus
+// for the non-overlapping channels 1/6/11, its recent frame rate and a bonus
+// for recent matches that fades out over RECENT_MATCH_MS. Visits are spread in
+// proportion to weight with smooth weighted round-robin and heavier channels
+// also dwell longer. A starvation guard keeps every channel revisited within
+// MAX_REVISIT_MS: channels fall due well before that, the most overdue one
+// jumps the queue, and dwells are cut to MIN_DWELL_MS until none is left.
+class AdaptiveHopScheduler : public ChannelHopScheduler {
+public:
+    static const uint16_t MIN_DWELL_MS = 150;
+    static const uint16_t DWELL_PER_WEIGHT_MS = 25;
+    static const uint16_t MAX_DWELL_MS = 800;
+    static const uint32_t MAX_REVISIT_MS = 5000;
+    static const uint32_t RECENT_MATCH_MS = 120000;
+
+    static const uint8_t BASE_WEIGHT = 4;
+    static const uint8_t PRIMARY_CHANNEL_BONUS = 4;
+    static const uint8_t MAX_TRAFFIC_BONUS = 8;
+    static const uint8_t MAX_MATCH_BONUS = 16;
+
+    explicit AdaptiveHopScheduler(uint8_t channelCount);
+
+    ChannelHop next(uint32_t nowMs) override;
+    void recordFrame(uint8_t channel) override;
+    void recordMatch(uint8_t channel, uint32_t nowMs) override;
+    size_t getPlan(ChannelPlanEntry* out, size_t maxEntries, uint32_t nowMs) const override;
+
+private:
+    struct ChannelState {
+        volatile uint32_t framesSeen;   // Written by the capture callback
+        volatile uint32_t matches;      // Written by the analysis path
+        volatile uint32_t lastMatchMs;
+        uint32_t lastVisitMs;
+        uint32_t framesAtVisitStart;
+        uint16_t frameRate;             // Frames per second, EWMA
+        int32_t credit;
+    };
+
+    uint8_t channelCount;
+    uint8_t current;
+    uint32_t visitStartMs;
+    uint32_t dueAfterMs;        // Time since a visit after which a channel is due
+    ChannelState channels[MAX_CHANNELS + 1];
+
+    uint8_t weightFor(uint8_t channel, uint32_t nowMs) const;
+    uint16_t dwellFor(uint8_t weight) const;
+    void closeVisit(uint32_t nowMs);
+};
+
+#endif
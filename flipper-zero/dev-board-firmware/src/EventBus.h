@@ -2,12 +2,16 @@
 #define EVENT_BUS_H
 
 #include <Arduino.h>
-#include <functional>
+#include "DeviceTracker.h"
+#include "EventDispatcher.h"
+#include "EventTopic.h"
+#include "ProximityEstimator.h"
 
 enum class EventType {
     WifiFrameCaptured,
     BluetoothDeviceFound,
     ThreatIdentified,
+    DevicePresenceChanged,
     SystemReady,
     AudioPlaybackRequested
 };
@@ -17,57 +21,165 @@ struct WiFiFrameEvent {
     char ssid[33];
     int8_t rssi;
     uint8_t channel;
-    uint8_t frameSubtype;  // 0x20 = probe, 0x80 = beacon
+    uint8_t frameSubtype;  // 0x04 = probe request, 0x05 = probe response, 0x08 = beacon
+    uint8_t dsChannel;     // DS Parameter Set channel, 0 if absent
+    uint8_t rateCount;     // Supported + extended supported rates
+    bool hasHTCapabilities;
+    bool hasVHTCapabilities;
+    uint16_t htCapabilityInfo;
+    uint32_t vhtCapabilityInfo;
+    uint8_t vendorOuiCount;
+    uint32_t vendorOuis[4];
 };
 
 struct BluetoothDeviceEvent {
     uint8_t mac[6];
+    uint8_t addressType;   // 0 = public, 1 = random
     char name[64];
     int8_t rssi;
-    bool hasServiceUUID;
-    char serviceUUID[64];
+    bool hasTxPower;
+    int8_t txPower;
+    uint8_t serviceUuid16Count;
+    uint16_t serviceUuid16[8];
+    uint8_t serviceUuid128Count;
+    uint8_t serviceUuid128[2][16];  // Little-endian, as advertised
+    bool hasManufacturerData;
+    uint16_t manufacturerId;
+    uint8_t manufacturerDataLength;
+    uint8_t manufacturerData[24];   // Truncated if longer
 };
 
 struct ThreatEvent {
     uint8_t mac[6];
     char identifier[64];
-    int8_t rssi;
+    int8_t rssi;                        // This frame
+    int8_t rssiSmoothed;                // Filtered over the device's recent frames
+    ProximityEstimator::Trend trend;
+    ProximityEstimator::Band distance;
     uint8_t channel;
     const char* radioType;
     uint8_t certainty;
     const char* category;
 };
 
+// Device-level view of threats, produced by the telemetry task's
+// DeviceTracker. `threat` is the latest detection for the device; for LEAVE
+// it is the last one seen before the session closed.
+struct DevicePresenceEvent {
+    DeviceTracker::Change change;
+    ThreatEvent threat;
+    TrackedDevice device;
+    uint16_t presentCount;      // Devices still present after this change
+    uint16_t alertsRaised;      // This session, as decided by the AlertPolicy
+    uint16_t alertsSuppressed;
+};
+
 struct AudioEvent {
     const char* soundFile;
 };
 
+// One event waiting for asynchronous delivery (see EventBus::setDelivery).
+struct QueuedEvent {
+    EventType type;
+    uint32_t postedUs;          // Stamped by EventDispatcher::post()
+    union {
+        WiFiFrameEvent wifiFrame;
+        BluetoothDeviceEvent bluetoothDevice;
+        ThreatEvent threat;
+        DevicePresenceEvent devicePresence;
+        AudioEvent audio;
+    };
+};
+
+// Static publish/subscribe hub. Each event type has its own EventTopic of
+// up to MAX_SUBSCRIBERS handlers, so new sinks (logging, stats, policy)
+// subscribe alongside the existing ones instead of being folded into them.
+// Handlers run in subscription order, on the publishing task unless the
+// event type is switched to ASYNC delivery.
 class EventBus {
 public:
-    typedef std::function<void(const WiFiFrameEvent&)> WiFiFrameHandler;
-    typedef std::function<void(const BluetoothDeviceEvent&)> BluetoothHandler;
-    typedef std::function<void(const ThreatEvent&)> ThreatHandler;
-    typedef std::function<void()> SystemEventHandler;
-    typedef std::function<void(const AudioEvent&)> AudioHandler;
+    static const uint8_t MAX_SUBSCRIBERS = 4;
+
+    // SYNC calls subscribers inside publish*(). ASYNC copies the event into a
+    // bounded queue, from any task or ISR, and the dispatcher task calls the
+    // subscribers: threats first, then presence, system and audio events,
+    // then single frames. A full queue drops the event. Batch subscribers
+    // always run on the publishing task.
+    enum Delivery : uint8_t { SYNC, ASYNC };
+    typedef EventDispatcher<QueuedEvent> Dispatcher;
+
+    static const uint16_t URGENT_QUEUE_DEPTH = 8;
+    static const uint16_t NORMAL_QUEUE_DEPTH = 8;
+    static const uint16_t BACKGROUND_QUEUE_DEPTH = 16;
+
+    typedef EventTopic<MAX_SUBSCRIBERS, const WiFiFrameEvent&> WiFiFrameTopic;
+    typedef EventTopic<MAX_SUBSCRIBERS, const BluetoothDeviceEvent&> BluetoothTopic;
+    typedef EventTopic<MAX_SUBSCRIBERS, const WiFiFrameEvent*, size_t> WiFiFrameBatchTopic;
+    typedef EventTopic<MAX_SUBSCRIBERS, const BluetoothDeviceEvent*, size_t> BluetoothBatchTopic;
+    typedef EventTopic<MAX_SUBSCRIBERS, const ThreatEvent&> ThreatTopic;
+    typedef EventTopic<MAX_SUBSCRIBERS, const DevicePresenceEvent&> DevicePresenceTopic;
+    typedef EventTopic<MAX_SUBSCRIBERS> SystemEventTopic;
+    typedef EventTopic<MAX_SUBSCRIBERS, const AudioEvent&> AudioTopic;
+
+    typedef WiFiFrameTopic::Handler WiFiFrameHandler;
+    typedef BluetoothTopic::Handler BluetoothHandler;
+    typedef WiFiFrameBatchTopic::Handler WiFiFrameBatchHandler;
+    typedef BluetoothBatchTopic::Handler BluetoothBatchHandler;
+    typedef ThreatTopic::Handler ThreatHandler;
+    typedef DevicePresenceTopic::Handler DevicePresenceHandler;
+    typedef SystemEventTopic::Handler SystemEventHandler;
+    typedef AudioTopic::Handler AudioHandler;
 
     static void publishWifiFrame(const WiFiFrameEvent& event);
     static void publishBluetoothDevice(const BluetoothDeviceEvent& event);
+    // A batch goes whole to the batch subscribers, then frame by frame to the
+    // single-frame subscribers.
+    static void publishWifiFrames(const WiFiFrameEvent* events, size_t count);
+    static void publishBluetoothDevices(const BluetoothDeviceEvent* events, size_t count);
     static void publishThreat(const ThreatEvent& event);
+    static void publishDevicePresence(const DevicePresenceEvent& event);
     static void publishSystemReady();
     static void publishAudioRequest(const AudioEvent& event);
 
-    static void subscribeWifiFrame(WiFiFrameHandler handler);
-    static void subscribeBluetoothDevice(BluetoothHandler handler);
-    static void subscribeThreat(ThreatHandler handler);
-    static void subscribeSystemReady(SystemEventHandler handler);
-    static void subscribeAudioRequest(AudioHandler handler);
+    // Each returns false if the topic already has MAX_SUBSCRIBERS handlers
+    // or this handler.
+    static bool subscribeWifiFrame(WiFiFrameHandler handler);
+    static bool subscribeBluetoothDevice(BluetoothHandler handler);
+    static bool subscribeWifiFrames(WiFiFrameBatchHandler handler);
+    static bool subscribeBluetoothDevices(BluetoothBatchHandler handler);
+    static bool subscribeThreat(ThreatHandler handler);
+    static bool subscribeDevicePresence(DevicePresenceHandler handler);
+    static bool subscribeSystemReady(SystemEventHandler handler);
+    static bool subscribeAudioRequest(AudioHandler handler);
+
+    // Creates the queues and the dispatcher task (TaskTopology::DISPATCH).
+    // Until it is running, and for good if it fails to start, types set to
+    // ASYNC are delivered synchronously instead, so a failed start costs the
+    // decoupling but never the events.
+    static bool startDispatcher();
+    // Set during setup, before the tasks that publish `type` start.
+    static void setDelivery(EventType type, Delivery delivery);
+    static Dispatcher::QueueStats getDispatchStats(Dispatcher::Priority priority);
+    static void resetDispatchStats();
 
 private:
-    static WiFiFrameHandler wifiHandler;
-    static BluetoothHandler bluetoothHandler;
-    static ThreatHandler threatHandler;
-    static SystemEventHandler systemReadyHandler;
-    static AudioHandler audioHandler;
+    static WiFiFrameTopic wifiTopic;
+    static BluetoothTopic bluetoothTopic;
+    static WiFiFrameBatchTopic wifiBatchTopic;
+    static BluetoothBatchTopic bluetoothBatchTopic;
+    static ThreatTopic threatTopic;
+    static DevicePresenceTopic devicePresenceTopic;
+    static SystemEventTopic systemReadyTopic;
+    static AudioTopic audioTopic;
+
+    static Dispatcher dispatcher;
+    static uint8_t asyncTypes;      // Bit n set = EventType n is ASYNC
+    static bool dispatching;        // Dispatcher task is running
+
+    static bool isAsync(EventType type);
+    static void post(QueuedEvent& event);
+    static void deliver(const QueuedEvent& event);
+    static void dispatchTask(void* param);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,189 @@
+#include "EvidenceScorer.h"
+
+#include <string.h>
+
+// logit(weight / 100) in Q8 nats; 0 and 100 are clamped to 1 and 99.
+static const int16_t WEIGHT_LOG_ODDS[101] = {
+    -1176, -1176, -996, -890, -814, -754, -704, -662, -625, -592,
+    -562, -535, -510, -487, -465, -444, -425, -406, -388, -371,
+    -355, -339, -324, -309, -295, -281, -268, -255, -242, -229,
+    -217, -205, -193, -181, -170, -158, -147, -136, -125, -115,
+    -104, -93, -83, -72, -62, -51, -41, -31, -20, -10,
+    0, 10, 20, 31, 41, 51, 62, 72, 83, 93,
+    104, 115, 125, 136, 147, 158, 170, 181, 193, 205,
+    217, 229, 242, 255, 268, 281, 295, 309, 324, 339,
+    355, 371, 388, 406, 425, 444, 465, 487, 510, 535,
+    562, 592, 625, 662, 704, 754, 814, 890, 996, 1176,
+    1176
+};
+
+// Logistic in permille, sampled every 1/8 nat from -8 to +8.
+static const int32_t LOGISTIC_MIN = -2048;
+static const uint8_t LOGISTIC_STEP_SHIFT = 5;
+static const uint16_t LOGISTIC_PERMILLE[129] = {
+    0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1,
+    2, 2, 2, 2, 2, 3, 3, 4, 4, 5, 5, 6,
+    7, 8, 9, 10, 11, 12, 14, 16, 18, 20, 23, 26,
+    29, 33, 37, 42, 47, 53, 60, 68, 76, 85, 95, 107,
+    119, 133, 148, 165, 182, 202, 223, 245, 269, 294, 321, 349,
+    378, 407, 438, 469, 500, 531, 562, 593, 622, 651, 679, 706,
+    731, 755, 777, 798, 818, 835, 852, 867, 881, 893, 905, 915,
+    924, 932, 940, 947, 953, 958, 963, 967, 971, 974, 977, 980,
+    982, 984, 986, 988, 989, 990, 991, 992, 993, 994, 995, 995,
+    996, 996, 997, 997, 998, 998, 998, 998, 998, 999, 999, 999,
+    999, 999, 999, 999, 999, 1000, 1000, 1000, 1000
+};
+
+static const uint8_t SETS = EvidenceScorer::CAPACITY / EvidenceScorer::WAYS;
+
+static int16_t clampHistory(int32_t value) {
+    if (value < EvidenceScorer::HISTORY_MIN) return EvidenceScorer::HISTORY_MIN;
+    if (value > EvidenceScorer::HISTORY_MAX) return EvidenceScorer::HISTORY_MAX;
+    return (int16_t)value;
+}
+
+EvidenceScorer::EvidenceScorer() {
+    clear();
+    setAlertThreshold(DEFAULT_ALERT_CERTAINTY);
+}
+
+void EvidenceScorer::clear() {
+    memset(records, 0, sizeof(records));
+}
+
+void EvidenceScorer::setAlertThreshold(uint8_t certainty) {
+    if (certainty < 1) certainty = 1;
+    if (certainty > 99) certainty = 99;
+    alertCertainty = certainty;
+    alertLogOdds = weightToLogOdds(certainty);
+}
+
+int16_t EvidenceScorer::weightToLogOdds(uint8_t weight) {
+    return WEIGHT_LOG_ODDS[weight > 100 ? 100 : weight];
+}
+
+uint8_t EvidenceScorer::logOddsToCertainty(int32_t logOdds) {
+    int32_t offset = logOdds - LOGISTIC_MIN;
+    if (offset <= 0) return 0;
+    size_t index = (size_t)(offset >> LOGISTIC_STEP_SHIFT);
+    if (index >= 128) return 100;
+
+    int32_t low = LOGISTIC_PERMILLE[index];
+    int32_t high = LOGISTIC_PERMILLE[index + 1];
+    int32_t fraction = offset & ((1 << LOGISTIC_STEP_SHIFT) - 1);
+    int32_t permille = low + (((high - low) * fraction) >> LOGISTIC_STEP_SHIFT);
+    return (uint8_t)((permille + 5) / 10);
+}
+
+// Halves per HALF_LIFE_MS, with a linear step inside the current half-life.
+int16_t EvidenceScorer::decay(int16_t value, uint32_t elapsedMs) {
+    uint32_t halvings = elapsedMs / HALF_LIFE_MS;
+    if (halvings >= 15) return 0;
+
+    int32_t result = value / (1 << halvings);
+    int32_t fraction = (int32_t)((elapsedMs % HALF_LIFE_MS) >> 8);
+    result -= result * fraction / (int32_t)((2 * HALF_LIFE_MS) >> 8);
+    return (int16_t)result;
+}
+
+int32_t EvidenceScorer::total(const Record& record) {
+    int32_t sum = weightToLogOdds(PRIOR_PERCENT) + record.history;
+    for (uint8_t kind = 0; kind < SignatureSet::KIND_COUNT; kind++) {
+        sum += record.kindEvidence[kind];
+    }
+    return sum;
+}
+
+EvidenceScorer::Record& EvidenceScorer::findRecord(const uint8_t* key, uint32_t nowMs) {
+    uint32_t h = ((uint32_t)key[2] << 24) | ((uint32_t)key[3] << 16) | ((uint32_t)key[4] << 8) | key[5];
+    h ^= ((uint32_t)key[0] << 8) | key[1];
+    h *= 2654435761u;
+    Record* set = &records[(h >> 24) % SETS * WAYS];
+
+    Record* victim = nullptr;
+    int32_t weakest = 0;
+    for (uint8_t way = 0; way < WAYS; way++) {
+        Record& record = set[way];
+        if (!record.used) {
+            if (!victim || victim->used) victim = &record;
+            continue;
+        }
+        if (memcmp(record.key, key, 6) == 0) return record;
+        if (victim && !victim->used) continue;
+
+        // Compare as of now, so a stale record loses to a recent weak one
+        Record decayed = record;
+        uint32_t elapsed = nowMs - record.lastUpdateMs;
+        for (uint8_t kind = 0; kind < SignatureSet::KIND_COUNT; kind++) {
+            decayed.kindEvidence[kind] = decay(record.kindEvidence[kind], elapsed);
+        }
+        decayed.history = decay(record.history, elapsed);
+        int32_t strength = total(decayed);
+        if (!victim || strength < weakest) {
+            victim = &record;
+            weakest = strength;
+        }
+    }
+
+    memset(victim, 0, sizeof(*victim));
+    memcpy(victim->key, key, 6);
+    victim->used = true;
+    victim->lastUpdateMs = nowMs;
+    return *victim;
+}
+
+EvidenceScore EvidenceScorer::update(const EvidenceObservation& observation, uint32_t nowMs) {
+    uint8_t key[6];
+    memcpy(key, observation.mac, 6);
+    key[5] &= 0xFC;
+    Record& record = findRecord(key, nowMs);
+
+    uint32_t elapsed = nowMs - record.lastUpdateMs;
+    record.lastUpdateMs = nowMs;
+    int16_t prior = weightToLogOdds(PRIOR_PERCENT);
+    for (uint8_t kind = 0; kind < SignatureSet::KIND_COUNT; kind++) {
+        int16_t evidence = decay(record.kindEvidence[kind], elapsed);
+        if (observation.weights[kind] > 0) {
+            int16_t fresh = weightToLogOdds(observation.weights[kind]) - prior;
+            if (fresh > evidence) evidence = fresh;
+        }
+        record.kindEvidence[kind] = evidence;
+    }
+
+    int32_t history = decay(record.history, elapsed);
+    if (record.radios != 0 && !(record.radios & observation.radio)) {
+        history += CROSS_RADIO_BONUS;
+    }
+    record.radios |= observation.radio;
+
+    if (record.sightings == 0 || nowMs - record.lastSightingMs >= SIGHTING_INTERVAL_MS) {
+        if (record.sightings > 0) {
+            history += SIGHTING_BONUS;
+
+            int32_t drift = observation.rssi * 16 - record.rssiAvgQ4;
+            if (drift < 0) drift = -drift;
+            if (record.sightings >= STEADY_RSSI_MIN_SIGHTINGS && drift <= STEADY_RSSI_DB * 16) {
+                history += STEADY_RSSI_BONUS;
+            }
+            // Fingerprints only compare within one radio
+            if (observation.fingerprint != 0 && record.fingerprint != 0 && observation.radio == record.lastRadio) {
+                history += (observation.fingerprint == record.fingerprint) ? FINGERPRINT_BONUS : FINGERPRINT_PENALTY;
+            }
+            record.rssiAvgQ4 += (int16_t)((observation.rssi * 16 - record.rssiAvgQ4) / 8);
+        } else {
+            record.rssiAvgQ4 = (int16_t)(observation.rssi * 16);
+        }
+        if (record.sightings < 0xFFFF) record.sightings++;
+        record.lastSightingMs = nowMs;
+    }
+    if (observation.fingerprint != 0) record.fingerprint = observation.fingerprint;
+    record.lastRadio = observation.radio;
+    record.history = clampHistory(history);
+
+    EvidenceScore score;
+    int32_t logOdds = total(record);
+    score.logOdds = (int16_t)logOdds;
+    score.certainty = logOddsToCertainty(logOdds);
+    score.alert = logOdds >= alertLogOdds;
+    return score;
+}
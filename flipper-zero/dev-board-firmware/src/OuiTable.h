@@ -0,0 +1,53 @@
+#ifndef OUI_TABLE_H
+#define OUI_TABLE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Sorted set of 24-bit OUIs, each packed big-endian into a uint32_t
+// (58:8e:81 -> 0x588e81). The table itself is not owned, so the same view
+// works over a constexpr array in flash or a list loaded at runtime.
+class OuiTable {
+public:
+    constexpr OuiTable() : entries(nullptr), count(0) {}
+    constexpr OuiTable(const uint32_t* entries, size_t count) : entries(entries), count(count) {}
+
+    static uint32_t fromMac(const uint8_t* mac) {
+        return ((uint32_t)mac[0] << 16) | ((uint32_t)mac[1] << 8) | mac[2];
+    }
+
+    // True if `table` is strictly ascending. Splits the range in half so the
+    // constexpr recursion depth stays logarithmic for very large tables.
+    static constexpr bool isSorted(const uint32_t* table, size_t count) {
+        return count < 2 ||
+               (isSorted(table, count / 2) &&
+                table[count / 2 - 1] < table[count / 2] &&
+                isSorted(table + count / 2, count - count / 2));
+    }
+
+    // Binary search whose only branch is the loop; the probe itself compiles
+    // to a conditional move. Returns the entry index, or -1.
+    int find(uint32_t oui) const {
+        if (count == 0) return -1;
+        const uint32_t* base = entries;
+        size_t n = count;
+        while (n > 1) {
+            size_t half = n / 2;
+            base = (base[half] <= oui) ? base + half : base;
+            n -= half;
+        }
+        return (*base == oui) ? (int)(base - entries) : -1;
+    }
+
+    int find(const uint8_t* mac) const { return find(fromMac(mac)); }
+    bool contains(uint32_t oui) const { return find(oui) >= 0; }
+    bool contains(const uint8_t* mac) const { return find(fromMac(mac)) >= 0; }
+
+    size_t size() const { return count; }
+
+private:
+    const uint32_t* entries;
+    size_t count;
+};
+
+#endif
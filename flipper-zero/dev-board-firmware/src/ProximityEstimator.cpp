@@ -0,0 +1,106 @@
+#include "ProximityEstimator.h"
+
+#include <string.h>
+
+static const uint8_t SETS = ProximityEstimator::CAPACITY / ProximityEstimator::WAYS;
+
+ProximityEstimator::ProximityEstimator() {
+    clear();
+}
+
+void ProximityEstimator::clear() {
+    memset(entries, 0, sizeof(entries));
+}
+
+ProximityEstimator::Entry& ProximityEstimator::findEntry(const uint8_t* mac, bool& fresh) {
+    uint32_t h = ((uint32_t)mac[2] << 24) | ((uint32_t)mac[3] << 16) | ((uint32_t)mac[4] << 8) | mac[5];
+    h ^= ((uint32_t)mac[0] << 8) | mac[1];
+    h *= 2654435761u;
+    Entry* set = &entries[(h >> 24) % SETS * WAYS];
+
+    Entry* victim = &set[0];
+    for (uint8_t way = 0; way < WAYS; way++) {
+        Entry& entry = set[way];
+        if (entry.used && memcmp(entry.mac, mac, 6) == 0) {
+            fresh = false;
+            return entry;
+        }
+        if (!victim->used) continue;
+        if (!entry.used || entry.lastMs < victim->lastMs) victim = &entry;
+    }
+
+    fresh = true;
+    return *victim;
+}
+
+// Moves `level` towards `target` by elapsed / tau, in Q12. While the device
+// is new the share is at least 1 / samples, a running mean, so the first
+// sample does not dominate.
+static int16_t smooth(int16_t level, int32_t target, uint32_t elapsedMs, uint32_t tauMs, uint8_t samples) {
+    int32_t share = elapsedMs >= tauMs ? 4096 : (int32_t)(elapsedMs * 4096 / tauMs);
+    int32_t warmup = 4096 / samples;
+    if (share < warmup) share = warmup;
+    return (int16_t)(level + (target - level) * share / 4096);
+}
+
+ProximityEstimator::Reading ProximityEstimator::update(const uint8_t* mac, int8_t rssi, uint32_t nowMs) {
+    bool fresh;
+    Entry& entry = findEntry(mac, fresh);
+    int32_t measuredQ8 = (int32_t)rssi * 256;
+    uint32_t elapsedMs = nowMs - entry.lastMs;
+
+    if (fresh || elapsedMs > RESET_GAP_MS) {
+        memcpy(entry.mac, mac, 6);
+        entry.used = true;
+        entry.samples = 1;
+        entry.trend = STEADY;
+        entry.fastQ8 = (int16_t)measuredQ8;
+        entry.slowQ8 = (int16_t)measuredQ8;
+    } else {
+        if (entry.samples < 0xFF) entry.samples++;
+        entry.fastQ8 = smooth(entry.fastQ8, measuredQ8, elapsedMs, FAST_TAU_MS, entry.samples);
+        entry.slowQ8 = smooth(entry.slowQ8, measuredQ8, elapsedMs, SLOW_TAU_MS, entry.samples);
+    }
+    entry.lastMs = nowMs;
+
+    int32_t rateQ8 = ((int32_t)entry.fastQ8 - entry.slowQ8) * 1000 / (int32_t)(SLOW_TAU_MS - FAST_TAU_MS);
+    if (entry.samples < TREND_MIN_SAMPLES) {
+        entry.trend = STEADY;
+    } else if (entry.trend == STEADY) {
+        if (rateQ8 >= TREND_ENTER_Q8) entry.trend = APPROACHING;
+        else if (rateQ8 <= -TREND_ENTER_Q8) entry.trend = DEPARTING;
+    } else if (entry.trend == APPROACHING ? rateQ8 < TREND_EXIT_Q8 : rateQ8 > -TREND_EXIT_Q8) {
+        entry.trend = STEADY;
+    }
+
+    Reading reading;
+    reading.rssi = (int8_t)((entry.fastQ8 - 128) / 256);
+    reading.rateQ8 = (int16_t)rateQ8;
+    reading.trend = entry.trend;
+    reading.band = bandFor(reading.rssi);
+    return reading;
+}
+
+ProximityEstimator::Band ProximityEstimator::bandFor(int8_t rssi) {
+    if (rssi >= BAND_IMMEDIATE_DBM) return IMMEDIATE;
+    if (rssi >= BAND_NEAR_DBM) return NEAR;
+    if (rssi >= BAND_FAR_DBM) return FAR;
+    return REMOTE;
+}
+
+const char* ProximityEstimator::trendName(Trend trend) {
+    switch (trend) {
+        case APPROACHING: return "approaching";
+        case DEPARTING:   return "departing";
+        default:          return "steady";
+    }
+}
+
+const char* ProximityEstimator::bandName(Band band) {
+    switch (band) {
+        case IMMEDIATE: return "immediate";
+        case NEAR:      return "near";
+        case FAR:       return "far";
+        default:        return "remote";
+    }
+}
@@ -0,0 +1,208 @@
+#include "SignatureDatabase.h"
+
+#include <string.h>
+
+static const uint8_t SECTION_TYPE_LIMIT = 9;
+
+size_t SignatureSet::count(Kind kind) const {
+    switch (kind) {
+        case MAC_PREFIX:   return macPrefixes.size();
+        case NETWORK_NAME: return networkNames.patternCount();
+        case BLE_NAME:     return bleNames.patternCount();
+        case SERVICE_UUID: return services.size();
+        default:           return 0;
+    }
+}
+
+SignatureInfo SignatureSet::getInfo(Kind kind, int index) const {
+    if (kind < KIND_COUNT && info[kind] && index >= 0 && (size_t)index < count(kind)) {
+        return info[kind][index];
+    }
+    return defaultInfo(kind);
+}
+
+SignatureInfo SignatureSet::defaultInfo(Kind kind) {
+    SignatureInfo result;
+    result.weight = (kind == SERVICE_UUID) ? 90 : 85;
+    result.category = (kind == SERVICE_UUID) ? ACOUSTIC_DETECTOR : SURVEILLANCE_DEVICE;
+    return result;
+}
+
+const char* SignatureSet::categoryName(uint8_t category) {
+    switch (category) {
+        case ACOUSTIC_DETECTOR: return "acoustic_detector";
+        default:                return "surveillance_device";
+    }
+}
+
+uint32_t SignatureDatabase::crc32(const uint8_t* data, size_t length, uint32_t crc) {
+    crc = ~crc;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+bool SignatureDatabase::parseNames(const uint8_t* data, size_t length, NameMatcher& out) {
+    if (length < 8) return false;
+    uint16_t header[4];
+    memcpy(header, data, sizeof(header));
+
+    NameAutomaton automaton;
+    automaton.stateCount = header[0];
+    automaton.classCount = header[1];
+    automaton.patternCount = header[2];
+    size_t states = automaton.stateCount;
+    size_t classes = automaton.classCount;
+    size_t patterns = automaton.patternCount;
+    if (states == 0 || classes == 0 || classes > 256 || patterns >= NameAutomaton::NO_PATTERN) return false;
+    if (length != 8 + 256 + sizeof(uint16_t) * (states * classes + 2 * states + patterns)) return false;
+
+    automaton.charClass = data + 8;
+    automaton.transitions = (const uint16_t*)(data + 8 + 256);
+    automaton.firstPattern = automaton.transitions + states * classes;
+    automaton.outputLink = automaton.firstPattern + states;
+    automaton.nextPattern = automaton.outputLink + states;
+
+    for (size_t i = 0; i < 256; i++) {
+        if (automaton.charClass[i] >= classes) return false;
+    }
+    for (size_t i = 0; i < states * classes; i++) {
+        if (automaton.transitions[i] >= states) return false;
+    }
+    for (size_t i = 0; i < patterns; i++) {
+        uint16_t next = automaton.nextPattern[i];
+        if (next != NameAutomaton::NO_PATTERN && next >= patterns) return false;
+    }
+    for (size_t s = 0; s < states; s++) {
+        uint16_t first = automaton.firstPattern[s];
+        if (first != NameAutomaton::NO_PATTERN && first >= patterns) return false;
+        if (automaton.outputLink[s] >= states) return false;
+
+        // Patterns end in exactly one state and every link lands on a state
+        // with output, so a well-formed chain is never longer than the
+        // pattern count. Anything longer is a cycle that would hang scan().
+        size_t steps = 0;
+        for (uint16_t id = first; id != NameAutomaton::NO_PATTERN; id = automaton.nextPattern[id]) {
+            if (++steps > patterns) return false;
+        }
+        steps = 0;
+        for (uint16_t link = automaton.outputLink[s]; link != 0; link = automaton.outputLink[link]) {
+            if (automaton.firstPattern[link] == NameAutomaton::NO_PATTERN) return false;
+            if (++steps > patterns) return false;
+        }
+    }
+
+    out = NameMatcher(automaton);
+    return true;
+}
+
+bool SignatureDatabase::parseUuids(const uint8_t* data, size_t length, UuidSet& out) {
+    if (length < 8) return false;
+    uint16_t header[2];
+    memcpy(header, data, sizeof(header));
+
+    UuidSetTable table;
+    table.entryCount = header[0];
+    table.slotMask = header[1];
+    size_t entries = table.entryCount;
+    size_t slots = (size_t)table.slotMask + 1;
+    if ((slots & (slots - 1)) != 0 || slots <= entries) return false;
+    if (length != 8 + sizeof(Uuid128) * entries + 2 * sizeof(uint16_t) * slots) return false;
+
+    table.entries = (const Uuid128*)(data + 8);
+    table.aliasSlots = (const uint16_t*)(data + 8 + sizeof(Uuid128) * entries);
+    table.fullSlots = table.aliasSlots + slots;
+
+    // Probing stops at an empty slot, so each table needs at least one.
+    bool aliasHasEmpty = false;
+    bool fullHasEmpty = false;
+    for (size_t i = 0; i < slots; i++) {
+        uint16_t alias = table.aliasSlots[i];
+        uint16_t full = table.fullSlots[i];
+        if (alias > entries || full > entries) return false;
+        if (alias == 0) aliasHasEmpty = true;
+        else if (!UuidSet::isBaseUuid(table.entries[alias - 1].bytes)) return false;
+        if (full == 0) fullHasEmpty = true;
+        else if (UuidSet::isBaseUuid(table.entries[full - 1].bytes)) return false;
+    }
+    if (!aliasHasEmpty || !fullHasEmpty) return false;
+
+    out = UuidSet(table);
+    return true;
+}
+
+bool SignatureDatabase::parse(const uint8_t* image, size_t length, SignatureSet& out, const char** error) {
+    const char* problem = nullptr;
+    SignatureSet result;
+    SignatureFileHeader header;
+    const uint8_t* sections[SECTION_TYPE_LIMIT] = {};
+    size_t sectionLengths[SECTION_TYPE_LIMIT] = {};
+
+    if (!image || ((uintptr_t)image & 3) || length < sizeof(header)) {
+        problem = "truncated header";
+    } else {
+        memcpy(&header, image, sizeof(header));
+        if (header.magic != MAGIC) problem = "bad magic";
+        else if (header.formatVersion != FORMAT_VERSION) problem = "unsupported format version";
+        else if (header.totalLength != length) problem = "length mismatch";
+        else if (crc32(image + sizeof(header), length - sizeof(header)) != header.crc32) problem = "checksum mismatch";
+        else if (sizeof(header) + (size_t)header.sectionCount * sizeof(SignatureSectionEntry) > length) problem = "truncated section table";
+    }
+
+    size_t dataStart = problem ? 0 : sizeof(header) + (size_t)header.sectionCount * sizeof(SignatureSectionEntry);
+    for (uint16_t i = 0; !problem && i < header.sectionCount; i++) {
+        SignatureSectionEntry entry;
+        memcpy(&entry, image + sizeof(header) + i * sizeof(entry), sizeof(entry));
+        if (entry.offset < dataStart || entry.offset > length || entry.length > length - entry.offset || (entry.offset & 3)) {
+            problem = "section out of bounds";
+        } else if (entry.type < SECTION_TYPE_LIMIT && entry.type != 0) {
+            if (sections[entry.type]) problem = "duplicate section";
+            sections[entry.type] = image + entry.offset;
+            sectionLengths[entry.type] = entry.length;
+        }
+    }
+
+    if (!problem && sections[SECTION_OUI]) {
+        const uint32_t* ouis = (const uint32_t*)sections[SECTION_OUI];
+        size_t count = sectionLengths[SECTION_OUI] / sizeof(uint32_t);
+        if (sectionLengths[SECTION_OUI] % sizeof(uint32_t) != 0 || !OuiTable::isSorted(ouis, count)) {
+            problem = "bad OUI table";
+        } else {
+            result.macPrefixes = OuiTable(ouis, count);
+        }
+    }
+    if (!problem && sections[SECTION_NETWORK_NAMES] &&
+        !parseNames(sections[SECTION_NETWORK_NAMES], sectionLengths[SECTION_NETWORK_NAMES], result.networkNames)) {
+        problem = "bad network name automaton";
+    }
+    if (!problem && sections[SECTION_BLE_NAMES] &&
+        !parseNames(sections[SECTION_BLE_NAMES], sectionLengths[SECTION_BLE_NAMES], result.bleNames)) {
+        problem = "bad BLE name automaton";
+    }
+    if (!problem && sections[SECTION_SERVICE_UUIDS] &&
+        !parseUuids(sections[SECTION_SERVICE_UUIDS], sectionLengths[SECTION_SERVICE_UUIDS], result.services)) {
+        problem = "bad service UUID set";
+    }
+
+    // Info sections must line up one-to-one with the tables parsed above.
+    for (uint8_t kind = 0; !problem && kind < SignatureSet::KIND_COUNT; kind++) {
+        uint8_t type = SECTION_OUI_INFO + kind;
+        if (!sections[type]) continue;
+        if (sectionLengths[type] != result.count((SignatureSet::Kind)kind) * sizeof(SignatureInfo)) {
+            problem = "info section does not match its table";
+        } else {
+            result.info[kind] = (const SignatureInfo*)sections[type];
+        }
+    }
+
+    if (error) *error = problem;
+    if (problem) return false;
+
+    result.revision = header.revision;
+    out = result;
+    return true;
+}
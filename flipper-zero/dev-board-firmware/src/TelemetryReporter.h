@@ -7,16 +7,13 @@
 class TelemetryReporter {
 public:
     void initialize();
-    void handleThreatDetection(const ThreatEvent& threat);
+    void handleDevicePresence(const DevicePresenceEvent& event);
     void handleWiFiFrameSeen(const WiFiFrameEvent& frame);
-    void update();
     bool isAlertActive() const;
     
 private:
     unsigned long bootTime;
-    unsigned long lastAlertMs;
     bool alertActive;
-    static const unsigned long ALERT_CLEAR_MS = 5000;
     unsigned long lastSeenMs;
     static const unsigned long SEEN_THROTTLE_MS = 200;
 
@@ -0,0 +1,64 @@
+#ifndef WIFI_FRAME_PARSER_H
+#define WIFI_FRAME_PARSER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Read-only view over a raw 802.11 management frame. Every pointer aliases the
+// buffer handed to WiFiFrameParser::parse(), so the view is only valid while
+// that buffer is (i.e. inside the promiscuous callback).
+struct ManagementFrameView {
+    static const uint8_t MAX_VENDOR_OUIS = 4;
+
+    uint8_t subtype;
+    const uint8_t* transmitter;       // Address 2 (source)
+    const uint8_t* bssid;             // Address 3
+
+    const uint8_t* ssid;              // nullptr if no SSID element
+    uint8_t ssidLength;
+    const uint8_t* rates;             // Supported Rates element body
+    uint8_t rateCount;
+    const uint8_t* extendedRates;     // Extended Supported Rates element body
+    uint8_t extendedRateCount;
+    const uint8_t* htCapabilities;    // 26-byte HT Capabilities body, or nullptr
+    const uint8_t* vhtCapabilities;   // 12-byte VHT Capabilities body, or nullptr
+    uint8_t dsChannel;                // DS Parameter Set channel, 0 if absent
+
+    uint32_t vendorOuis[MAX_VENDOR_OUIS];  // Distinct vendor-specific OUIs, in frame order
+    uint8_t vendorOuiCount;
+
+    const uint8_t* elements;          // First information element
+    size_t elementsLength;
+    uint8_t elementCount;
+    bool truncated;                   // An element ran past the end of the frame
+};
+
+class WiFiFrameParser {
+public:
+    static const uint8_t TYPE_MANAGEMENT = 0x00;
+    static const uint8_t SUBTYPE_PROBE_REQUEST = 0x04;
+    static const uint8_t SUBTYPE_PROBE_RESPONSE = 0x05;
+    static const uint8_t SUBTYPE_BEACON = 0x08;
+
+    static const uint8_t IE_SSID = 0;
+    static const uint8_t IE_SUPPORTED_RATES = 1;
+    static const uint8_t IE_DS_PARAMETER_SET = 3;
+    static const uint8_t IE_HT_CAPABILITIES = 45;
+    static const uint8_t IE_EXTENDED_RATES = 50;
+    static const uint8_t IE_VHT_CAPABILITIES = 191;
+    static const uint8_t IE_VENDOR_SPECIFIC = 221;
+
+    static const size_t HEADER_LENGTH = 24;
+    static const size_t HT_CONTROL_LENGTH = 4;
+    static const size_t FIXED_PARAMS_LENGTH = 12;  // Timestamp, interval, capabilities
+    static const size_t FCS_LENGTH = 4;
+
+    static uint8_t frameType(const uint8_t* frame) { return (frame[0] >> 2) & 0x03; }
+    static uint8_t frameSubtype(const uint8_t* frame) { return (frame[0] >> 4) & 0x0F; }
+
+    // Parses a beacon, probe request or probe response. `length` must exclude
+    // the FCS. Returns false for any other frame or if the fixed part is short.
+    static bool parse(const uint8_t* frame, size_t length, ManagementFrameView& view);
+};
+
+#endif
@@ -0,0 +1,70 @@
+#include "AlertPolicy.h"
+
+#include <string.h>
+
+static const uint32_t RATE_CREDIT_LIMIT_MS = AlertPolicy::RATE_INTERVAL_MS * AlertPolicy::RATE_BURST;
+
+AlertPolicy::AlertPolicy() {
+    clear();
+}
+
+void AlertPolicy::clear() {
+    memset(devices, 0, sizeof(devices));
+    memset(&stats, 0, sizeof(stats));
+    rateCreditMs = RATE_CREDIT_LIMIT_MS;
+    lastRefillMs = 0;
+}
+
+// Credit is kept in milliseconds of refill time, so the bucket needs no
+// fractional tokens: each alert costs RATE_INTERVAL_MS.
+bool AlertPolicy::takeRateToken(uint32_t nowMs) {
+    uint32_t elapsed = nowMs - lastRefillMs;
+    lastRefillMs = nowMs;
+    rateCreditMs = (elapsed >= RATE_CREDIT_LIMIT_MS - rateCreditMs) ? RATE_CREDIT_LIMIT_MS : rateCreditMs + elapsed;
+
+    if (rateCreditMs < RATE_INTERVAL_MS) return false;
+    rateCreditMs -= RATE_INTERVAL_MS;
+    return true;
+}
+
+AlertPolicy::Verdict AlertPolicy::evaluate(uint8_t index, bool newSession, uint8_t certainty,
+                                           int8_t rssi, uint32_t nowMs) {
+    if (index >= DeviceTracker::CAPACITY) return SUPPRESS;
+
+    DeviceAlertState& device = devices[index];
+    if (newSession) {
+        memset(&device, 0, sizeof(device));
+        device.armed = true;
+    }
+
+    Verdict verdict = SUPPRESS;
+    uint32_t sinceAlert = nowMs - device.lastAlertMs;
+    if (device.armed || sinceAlert >= COOLDOWN_MS) {
+        verdict = ALERT;
+    } else if (sinceAlert >= MIN_ESCALATION_GAP_MS &&
+               (certainty >= device.certainty + CERTAINTY_STEP || rssi >= device.rssi + RSSI_STEP_DB)) {
+        verdict = ESCALATE;
+    }
+
+    if (verdict == SUPPRESS) {
+        device.suppressed++;
+        stats.suppressedCooldown++;
+        return SUPPRESS;
+    }
+    if (!takeRateToken(nowMs)) {
+        // Keep a pending new-session alert armed so it goes out once the
+        // bucket refills; escalations and reminders just wait for the next one.
+        device.suppressed++;
+        stats.suppressedRateCap++;
+        return SUPPRESS;
+    }
+
+    if (verdict == ESCALATE) stats.escalations++;
+    else stats.alerts++;
+    device.armed = false;
+    device.lastAlertMs = nowMs;
+    device.raised++;
+    device.certainty = certainty;
+    device.rssi = rssi;
+    return verdict;
+}
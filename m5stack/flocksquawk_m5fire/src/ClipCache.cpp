@@ -0,0 +1,123 @@
+#include "ClipCache.h"
+
+#include <string.h>
+
+ClipCache::ClipCache()
+    : filesystem(nullptr), budgetBytes(0), usedBytes(0), useCounter(0), lastHandedOut(-1) {
+    memset(entries, 0, sizeof(entries));
+    memset(&stats, 0, sizeof(stats));
+}
+
+bool ClipCache::begin(fs::FS& filesystem) {
+    this->filesystem = &filesystem;
+    budgetBytes = psramFound() ? PSRAM_BUDGET : 0;
+    return budgetBytes > 0;
+}
+
+bool ClipCache::preload(const char* path) {
+    int8_t index = find(path);
+    if (index < 0) index = load(path, true);
+    if (index < 0) return false;
+    entries[index].pinned = true;
+    return true;
+}
+
+bool ClipCache::get(const char* path, Clip& clip) {
+    int8_t index = find(path);
+    if (index >= 0) {
+        stats.hits++;
+    } else {
+        stats.misses++;
+        index = load(path, false);
+        if (index < 0) return false;
+    }
+    Entry& entry = entries[index];
+    entry.lastUsed = ++useCounter;
+    lastHandedOut = index;
+    clip.data = entry.data;
+    clip.length = entry.length;
+    return true;
+}
+
+uint8_t ClipCache::count() const {
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < MAX_CLIPS; i++) {
+        if (entries[i].data) n++;
+    }
+    return n;
+}
+
+int8_t ClipCache::find(const char* path) const {
+    for (uint8_t i = 0; i < MAX_CLIPS; i++) {
+        if (entries[i].data && strcmp(entries[i].path, path) == 0) return i;
+    }
+    return -1;
+}
+
+int8_t ClipCache::load(const char* path, bool pinned) {
+    if (!filesystem || budgetBytes == 0 || strlen(path) >= MAX_PATH) return -1;
+    File file = filesystem->open(path, FILE_READ);
+    if (!file) return -1;
+    size_t length = file.size();
+    if (length == 0 || !makeRoom(length)) {
+        file.close();
+        if (length > 0) stats.rejected++;
+        return -1;
+    }
+
+    uint8_t* data = static_cast<uint8_t*>(ps_malloc(length));
+    if (!data) {
+        file.close();
+        stats.rejected++;
+        return -1;
+    }
+    size_t bytesRead = file.read(data, length);
+    file.close();
+    if (bytesRead != length) {
+        free(data);
+        return -1;
+    }
+
+    // makeRoom() left at least one slot free
+    for (uint8_t i = 0; i < MAX_CLIPS; i++) {
+        Entry& entry = entries[i];
+        if (entry.data) continue;
+        strncpy(entry.path, path, MAX_PATH - 1);
+        entry.path[MAX_PATH - 1] = '\0';
+        entry.data = data;
+        entry.length = length;
+        entry.lastUsed = ++useCounter;
+        entry.pinned = pinned;
+        usedBytes += length;
+        return i;
+    }
+    free(data);
+    return -1;
+}
+
+bool ClipCache::makeRoom(size_t length) {
+    if (length > budgetBytes) return false;
+    for (;;) {
+        bool slotFree = false;
+        int8_t victim = -1;
+        for (uint8_t i = 0; i < MAX_CLIPS; i++) {
+            const Entry& entry = entries[i];
+            if (!entry.data) {
+                slotFree = true;
+                continue;
+            }
+            if (entry.pinned || i == lastHandedOut) continue;
+            if (victim < 0 || entry.lastUsed < entries[victim].lastUsed) victim = i;
+        }
+        if (slotFree && usedBytes + length <= budgetBytes) return true;
+        if (victim < 0) return false;
+        evict(entries[victim]);
+    }
+}
+
+void ClipCache::evict(Entry& entry) {
+    usedBytes -= entry.length;
+    free(entry.data);
+    memset(&entry, 0, sizeof(entry));
+    stats.evictions++;
+}
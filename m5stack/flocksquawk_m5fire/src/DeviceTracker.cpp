@@ -0,0 +1,174 @@
+#include "DeviceTracker.h"
+
+#include <string.h>
+
+static_assert((DeviceTracker::CAPACITY * 2 & (DeviceTracker::CAPACITY * 2 - 1)) == 0,
+              "index size must be a power of two");
+
+DeviceTracker::DeviceTracker() {
+    clear();
+}
+
+void DeviceTracker::clear() {
+    memset(entries, 0, sizeof(entries));
+    memset(slots, 0, sizeof(slots));
+    memset(&stats, 0, sizeof(stats));
+    newest = NO_ENTRY;
+    oldest = NO_ENTRY;
+}
+
+uint8_t DeviceTracker::hashMac(const uint8_t* mac) {
+    // The OUI half is shared by every device of one vendor, so mix it in but
+    // let the low bytes dominate.
+    uint32_t h = ((uint32_t)mac[2] << 24) | ((uint32_t)mac[3] << 16) |
+                 ((uint32_t)mac[4] << 8) | mac[5];
+    h ^= ((uint32_t)mac[0] << 8) | mac[1];
+    h *= 2654435761u;
+    return (uint8_t)(h >> 24);
+}
+
+int DeviceTracker::findSlot(const uint8_t* mac) const {
+    for (uint8_t slot = hashMac(mac) & (INDEX_SLOTS - 1); ; slot = (slot + 1) & (INDEX_SLOTS - 1)) {
+        uint8_t entry = slots[slot];
+        if (entry == 0) return -1;
+        if (memcmp(entries[entry - 1].mac, mac, 6) == 0) return slot;
+    }
+}
+
+// Backward-shift deletion keeps probe chains intact without tombstones.
+void DeviceTracker::removeSlot(int slot) {
+    uint8_t hole = (uint8_t)slot;
+    uint8_t next = (hole + 1) & (INDEX_SLOTS - 1);
+    while (slots[next] != 0) {
+        uint8_t home = hashMac(entries[slots[next] - 1].mac) & (INDEX_SLOTS - 1);
+        if (((next - home) & (INDEX_SLOTS - 1)) >= ((next - hole) & (INDEX_SLOTS - 1))) {
+            slots[hole] = slots[next];
+            hole = next;
+        }
+        next = (next + 1) & (INDEX_SLOTS - 1);
+    }
+    slots[hole] = 0;
+}
+
+void DeviceTracker::unlink(uint8_t index) {
+    if (newer[index] != NO_ENTRY) older[newer[index]] = older[index];
+    else newest = older[index];
+    if (older[index] != NO_ENTRY) newer[older[index]] = newer[index];
+    else oldest = newer[index];
+}
+
+void DeviceTracker::pushNewest(uint8_t index) {
+    newer[index] = NO_ENTRY;
+    older[index] = newest;
+    if (newest != NO_ENTRY) newer[newest] = index;
+    newest = index;
+    if (oldest == NO_ENTRY) oldest = index;
+}
+
+const TrackedDevice* DeviceTracker::find(const uint8_t* mac) const {
+    int slot = findSlot(mac);
+    return slot < 0 ? nullptr : &entries[slots[slot] - 1];
+}
+
+void DeviceTracker::observe(const uint8_t* mac, int8_t rssi, uint8_t channel, uint8_t radio,
+                            uint32_t nowMs, Observation& out) {
+    out.change = NONE;
+    out.evictedPresent = false;
+
+    uint8_t index;
+    int slot = findSlot(mac);
+    if (slot >= 0) {
+        index = slots[slot] - 1;
+        unlink(index);
+    } else {
+        if (stats.tracked < CAPACITY) {
+            index = (uint8_t)stats.tracked++;
+        } else {
+            index = oldest;
+            unlink(index);
+            removeSlot(findSlot(entries[index].mac));
+            stats.evictions++;
+            if (entries[index].present) {
+                out.evictedPresent = true;
+                out.evicted = entries[index];
+                out.evicted.present = false;
+                stats.present--;
+                stats.sessionsClosed++;
+            }
+        }
+
+        TrackedDevice& fresh = entries[index];
+        memset(&fresh, 0, sizeof(fresh));
+        memcpy(fresh.mac, mac, 6);
+        fresh.firstSeenMs = nowMs;
+
+        uint8_t probe = hashMac(mac) & (INDEX_SLOTS - 1);
+        while (slots[probe] != 0) probe = (probe + 1) & (INDEX_SLOTS - 1);
+        slots[probe] = index + 1;
+    }
+    pushNewest(index);
+
+    TrackedDevice& device = entries[index];
+    if (!device.present) {
+        device.present = true;
+        device.sessions++;
+        device.sessionStartMs = nowMs;
+        device.sightings = 0;
+        device.radios = 0;
+        device.channelMask = 0;
+        device.rssiAvgQ4 = (int16_t)(rssi * 16);
+        device.rssiMin = rssi;
+        device.rssiMax = rssi;
+        stats.present++;
+        stats.sessionsOpened++;
+        out.change = ENTER;
+    } else {
+        device.rssiAvgQ4 += (int16_t)((rssi * 16 - device.rssiAvgQ4) / 4);
+        if (rssi < device.rssiMin) device.rssiMin = rssi;
+        if (rssi > device.rssiMax) device.rssiMax = rssi;
+    }
+
+    device.lastSeenMs = nowMs;
+    device.rssiLast = rssi;
+    device.sightings++;
+    device.totalSightings++;
+    device.radios |= radio;
+    if (channel > 0 && channel < 16) device.channelMask |= (uint16_t)(1u << channel);
+
+    if (out.change == NONE) {
+        uint32_t sinceReport = nowMs - device.lastReportMs;
+        int moved = device.rssiAverage() - device.reportedRssi;
+        if (moved < 0) moved = -moved;
+        if (sinceReport >= UPDATE_INTERVAL_MS ||
+            (sinceReport >= MIN_UPDATE_GAP_MS && moved >= RSSI_UPDATE_DB)) {
+            out.change = UPDATE;
+        }
+    }
+    if (out.change != NONE) {
+        device.lastReportMs = nowMs;
+        device.reportedRssi = device.rssiAverage();
+    }
+
+    out.index = index;
+    out.device = &device;
+}
+
+bool DeviceTracker::expireNext(uint32_t nowMs, Observation& out) {
+    // The list is in last-seen order, so once one present device is still
+    // fresh every newer one is too.
+    for (uint8_t index = oldest; index != NO_ENTRY; index = newer[index]) {
+        TrackedDevice& device = entries[index];
+        if (!device.present) continue;
+        if (nowMs - device.lastSeenMs < PRESENCE_TIMEOUT_MS) return false;
+
+        device.present = false;
+        stats.present--;
+        stats.sessionsClosed++;
+        out.change = LEAVE;
+        out.index = index;
+        out.device = &device;
+        out.evictedPresent = false;
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,102 @@
+#ifndef DEVICE_TRACKER_H
+#define DEVICE_TRACKER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Everything known about one transmitter. Session fields describe the current
+// (or, once `present` is false, the last) presence session.
+struct TrackedDevice {
+    uint8_t mac[6];
+    uint8_t radios;             // DeviceTracker::RADIO_* bits seen this session
+    bool present;
+    uint16_t channelMask;       // Bit n set = seen on WiFi channel n this session
+    uint16_t sessions;          // Sessions opened since the device was first tracked
+    uint32_t firstSeenMs;
+    uint32_t sessionStartMs;
+    uint32_t lastSeenMs;
+    uint32_t lastReportMs;      // Last ENTER or UPDATE
+    uint32_t sightings;         // This session
+    uint32_t totalSightings;
+    int16_t rssiAvgQ4;          // Moving average in 1/16 dBm
+    int8_t rssiMin;
+    int8_t rssiMax;
+    int8_t rssiLast;
+    int8_t reportedRssi;        // Average at the last ENTER or UPDATE
+
+    int8_t rssiAverage() const { return (int8_t)(rssiAvgQ4 / 16); }
+    uint32_t sessionDurationMs() const { return lastSeenMs - sessionStartMs; }
+};
+
+struct DeviceTrackerStats {
+    uint16_t tracked;
+    uint16_t present;
+    uint32_t evictions;
+    uint32_t sessionsOpened;
+    uint32_t sessionsClosed;
+};
+
+// Fixed-capacity table of recently detected devices, keyed by MAC. Lookups go
+// through an open-addressed index; entries sit on an intrusive list kept in
+// last-seen order, so the least recently seen device is evicted when the
+// table is full and sessions time out from the tail. No allocation, and not
+// thread-safe: one task owns the tracker.
+class DeviceTracker {
+public:
+    static const uint8_t CAPACITY = 64;
+    static const uint8_t NO_ENTRY = 0xFF;
+
+    static const uint8_t RADIO_WIFI = 0x01;
+    static const uint8_t RADIO_BLE = 0x02;
+
+    static const uint32_t PRESENCE_TIMEOUT_MS = 30000;  // Unseen this long = left
+    static const uint32_t UPDATE_INTERVAL_MS = 5000;    // Heartbeat while present
+    static const uint32_t MIN_UPDATE_GAP_MS = 1000;     // Floor for RSSI-driven updates
+    static const uint8_t RSSI_UPDATE_DB = 6;            // Average move that forces an update
+
+    enum Change { NONE, ENTER, UPDATE, LEAVE };
+
+    struct Observation {
+        Change change;
+        uint8_t index;                  // Entry for this device, stable until evicted
+        const TrackedDevice* device;
+        bool evictedPresent;            // A present device was pushed out to make room
+        TrackedDevice evicted;          // Valid when evictedPresent is set
+    };
+
+    DeviceTracker();
+
+    void clear();
+
+    // Records one sighting. `change` is ENTER when a session opens, UPDATE
+    // when the device is due another report and NONE otherwise.
+    void observe(const uint8_t* mac, int8_t rssi, uint8_t channel, uint8_t radio,
+                 uint32_t nowMs, Observation& out);
+
+    // Closes the oldest session idle for PRESENCE_TIMEOUT_MS. Returns false
+    // when none has expired; call until it does to drain them all.
+    bool expireNext(uint32_t nowMs, Observation& out);
+
+    const TrackedDevice* find(const uint8_t* mac) const;
+    const TrackedDevice& getEntry(uint8_t index) const { return entries[index]; }
+    const DeviceTrackerStats& getStats() const { return stats; }
+
+private:
+    static const uint8_t INDEX_SLOTS = CAPACITY * 2;  // Power of two
+
+    TrackedDevice entries[CAPACITY];
+    uint8_t newer[CAPACITY];        // Towards the most recently seen
+    uint8_t older[CAPACITY];        // Towards the least recently seen
+    uint8_t slots[INDEX_SLOTS];     // Entry index + 1, 0 = empty
+    uint8_t newest;
+    uint8_t oldest;
+    DeviceTrackerStats stats;
+
+    static uint8_t hashMac(const uint8_t* mac);
+    int findSlot(const uint8_t* mac) const;
+    void removeSlot(int slot);
+    void unlink(uint8_t index);
+    void pushNewest(uint8_t index);
+};
+
+#endif
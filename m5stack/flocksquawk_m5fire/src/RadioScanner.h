@@ -2,13 +2,23 @@
 #define RADIO_SCANNER_H
 
 #include <Arduino.h>
+#include <atomic>
 #include <WiFi.h>
 #include <NimBLEDevice.h>
 #include <NimBLEScan.h>
 #include <NimBLEAdvertisedDevice.h>
 #include "esp_wifi.h"
 #include "esp_wifi_types.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 #include "EventBus.h"
+#include "CaptureFilter.h"
+#include "ChannelHopScheduler.h"
+#include "FrameRing.h"
+#include "TaskTopology.h"
+#include "WiFiFrameParser.h"
+#include "BLEAdvertisementParser.h"
 
 class RadioScannerManager {
 public:
@@ -16,24 +26,82 @@ public:
     static const uint16_t CHANNEL_SWITCH_MS = 500;
     static const uint8_t BLE_SCAN_SECONDS = 1;
     static const uint32_t BLE_SCAN_INTERVAL_MS = 5000;
+    static const bool BLE_CONTINUOUS_SCAN = true;   // false = BLE_SCAN_SECONDS every BLE_SCAN_INTERVAL_MS
+    static const uint32_t BLE_SCAN_RESTART_MS = 10000;
+    static const uint16_t BLE_SCAN_INTERVAL_SPARSE_MS = 40;
+    static const uint16_t BLE_SCAN_INTERVAL_DENSE_MS = 160;
+    static const uint16_t BLE_DENSE_ADS_PER_SEC = 40;
+    static const size_t WIFI_FRAME_RING_SIZE = 64;  // Must be a power of two
+    static const size_t BLE_EVENT_RING_SIZE = 32;   // Must be a power of two
+    static const size_t ANALYSIS_BATCH_SIZE = 32;   // Frames handed to the analyzer at once
+
+    struct CaptureStats {
+        uint32_t framesQueued;
+        uint32_t framesDropped;
+        uint32_t ringHighWater;
+        uint32_t bleEventsQueued;
+        uint32_t bleEventsDropped;
+    };
+
+    struct HopStats {
+        uint32_t hops;
+        int32_t lastJitterUs;    // Actual minus scheduled dwell
+        uint32_t maxJitterUs;    // Largest |jitter| seen
+        uint32_t meanJitterUs;   // Running average of |jitter|
+    };
+
+    struct BLEScanStats {
+        uint32_t advertisements;
+        uint32_t restarts;
+        uint16_t intervalMs;
+        uint16_t windowMs;
+    };
 
     void initialize();
     void update();  // Call from main loop
+    static CaptureStats getCaptureStats();
+    static HopStats getHopStats();
+    static BLEScanStats getBLEScanStats();
+    // Percentage of each BLE scan interval spent listening (10-100); applied on the next scan restart.
+    static void setBLEDutyCycle(uint8_t percent);
+    // Swap the hop strategy at runtime; nullptr restores the adaptive default.
+    static void setHopScheduler(ChannelHopScheduler* scheduler);
+    static ChannelHopScheduler* getHopScheduler();
+    static void noteThreat(const ThreatEvent& threat);  // Feeds WiFi hits back into hopping
     static uint8_t getCurrentWifiChannel();
     static bool isBluetoothScanning();
     
 private:
     static uint8_t currentWifiChannel;
-    static unsigned long lastChannelSwitch;
+    static uint16_t currentDwellMs;
+    static std::atomic<esp_timer_handle_t> hopTimer;   // Null = update() hops from loop()
+    static int64_t lastHopUs;
+    static HopStats hopStats;
+    static AdaptiveHopScheduler defaultHopScheduler;
+    static ChannelHopScheduler* hopScheduler;
+    static FrameRing<WiFiFrameEvent, WIFI_FRAME_RING_SIZE> wifiFrameRing;
+    static TaskHandle_t analysisTaskHandle;
     static unsigned long lastBLEScan;
+    static uint8_t bleDutyPercent;
+    static uint16_t bleIntervalMs;
+    static volatile uint32_t bleAdvertisements;
+    static uint32_t bleAdsAtRestart;
+    static uint32_t bleRestarts;
+    static FrameRing<BluetoothDeviceEvent, BLE_EVENT_RING_SIZE> bleEventRing;
     static NimBLEScan* bleScanner;
     static bool isScanningBLE;
     
+    void startAnalysisTask();
     void configureWiFiSniffer();
     void configureBluetoothScanner();
-    void switchWifiChannel();
+    void startChannelHopTimer();
     void performBLEScan();
+    static uint16_t bleWindowMs();
+    static void applyBLEScanTiming();
     static void wifiPacketHandler(void* buffer, wifi_promiscuous_pkt_type_t type);
+    static void analysisTask(void* param);
+    static void hopTimerCallback(void* arg);
+    static void hopChannel();
     
     // BLE callback handler
     class BLEDeviceObserver;
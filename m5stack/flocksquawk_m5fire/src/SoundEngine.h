@@ -6,7 +6,11 @@
 #include <SD.h>
 #include <M5Unified.h>
 #include "EventBus.h"
+#include "ClipCache.h"
 
+// WAV playback through M5.Speaker. Clips come from the clip cache, loaded
+// from SD once; a clip the cache cannot hold is read into a buffer for
+// that one play and freed afterwards.
 class SoundEngine {
 public:
     static const uint8_t SD_SCK = 18;
@@ -25,11 +29,13 @@ public:
     
 private:
     float volumeLevel;
-    uint8_t* asyncBuffer = nullptr;
+    ClipCache clips;
+    uint8_t* asyncBuffer = nullptr;     // Uncached clip only; cached clips are never freed here
     size_t asyncLength = 0;
     bool asyncActive = false;
     
     bool loadWavFromSd(const char* filename, uint8_t** outData, size_t* outLength);
+    void releaseAsyncBuffer();
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,94 @@
+#ifndef BATCH_MATCHER_H
+#define BATCH_MATCHER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "SignatureDatabase.h"
+
+// Signature table indices for one frame, -1 = no match.
+struct BatchMatch {
+    int32_t macIndex;
+    int32_t nameIndex;
+    int32_t uuidIndex;
+};
+
+// Signature matching over a batch of frames, one table at a time: every
+// frame's OUI is probed, then every name runs through the automaton, then
+// every UUID list is looked up. Each stage keeps one table hot in cache and
+// runs one loop whose branches repeat frame after frame, instead of
+// alternating between three tables per frame.
+//
+// Frames are any record type with the fields a stage reads (`mac`, a name
+// array, the service UUID lists), so the firmware's event structs are used
+// in place. Records with `skip[i]` set are left untouched, which lets the
+// caller drop cached or listed frames before matching. Header-only, like
+// FrameRing, so each variant instantiates it for its own event types.
+namespace BatchMatcher {
+
+static const int32_t NO_MATCH = -1;
+static const size_t MAX_NAME_HITS = 16;    // Patterns weighed per name
+
+inline void reset(BatchMatch* out, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        out[i].macIndex = NO_MATCH;
+        out[i].nameIndex = NO_MATCH;
+        out[i].uuidIndex = NO_MATCH;
+    }
+}
+
+template <typename Frame>
+void matchMacPrefixes(const OuiTable& table, const Frame* frames, size_t count,
+                      const uint8_t* skip, BatchMatch* out) {
+    for (size_t i = 0; i < count; i++) {
+        if (skip[i]) continue;
+        out[i].macIndex = table.find(frames[i].mac);
+    }
+}
+
+// Of every pattern found in `text`, the one with the highest weight in
+// `set`; a tie goes to the pattern listed first, so the order of words in a
+// name never decides. `kind` is NETWORK_NAME or BLE_NAME.
+inline int32_t bestName(const SignatureSet& set, SignatureSet::Kind kind, const char* text) {
+    const NameMatcher& matcher = (kind == SignatureSet::NETWORK_NAME) ? set.networkNames : set.bleNames;
+    uint16_t hits[MAX_NAME_HITS];
+    size_t found = matcher.scan(text, hits, MAX_NAME_HITS);
+    int32_t best = NO_MATCH;
+    uint8_t bestWeight = 0;
+    for (size_t h = 0; h < found; h++) {
+        int32_t pattern = hits[h];
+        uint8_t weight = set.getInfo(kind, pattern).weight;
+        if (best == NO_MATCH || weight > bestWeight || (weight == bestWeight && pattern < best)) {
+            best = pattern;
+            bestWeight = weight;
+        }
+    }
+    return best;
+}
+
+// `name` selects the NUL-terminated array to scan, e.g. &WiFiFrameEvent::ssid.
+// Empty names are not scanned.
+template <typename Frame, size_t Length>
+void matchNames(const SignatureSet& set, SignatureSet::Kind kind, const Frame* frames, size_t count,
+                char (Frame::*name)[Length], const uint8_t* skip, BatchMatch* out) {
+    for (size_t i = 0; i < count; i++) {
+        const char* text = frames[i].*name;
+        if (skip[i] || text[0] == '\0') continue;
+        out[i].nameIndex = bestName(set, kind, text);
+    }
+}
+
+template <typename Frame>
+void matchServices(const UuidSet& services, const Frame* frames, size_t count,
+                   const uint8_t* skip, BatchMatch* out) {
+    for (size_t i = 0; i < count; i++) {
+        if (skip[i]) continue;
+        const Frame& frame = frames[i];
+        if (frame.serviceUuid16Count == 0 && frame.serviceUuid128Count == 0) continue;
+        out[i].uuidIndex = services.findAny(frame.serviceUuid16, frame.serviceUuid16Count,
+                                            frame.serviceUuid128, frame.serviceUuid128Count);
+    }
+}
+
+}  // namespace BatchMatcher
+
+#endif
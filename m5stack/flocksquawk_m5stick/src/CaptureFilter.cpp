@@ -0,0 +1,61 @@
+#include "CaptureFilter.h"
+#include "WiFiFrameParser.h"
+
+volatile uint16_t CaptureFilter::subtypeMask = CaptureFilter::DEFAULT_SUBTYPE_MASK;
+uint32_t CaptureFilter::acceptedFrames[CaptureFilter::MAX_CHANNEL + 1] = {0};
+uint32_t CaptureFilter::rejectedFrames[CaptureFilter::MAX_CHANNEL + 1] = {0};
+
+void CaptureFilter::applyDriverFilter() {
+    // The driver can only filter by frame type; subtypes are handled in accept().
+    wifi_promiscuous_filter_t filter;
+    filter.filter_mask = WIFI_PROMIS_FILTER_MASK_MGMT;
+    esp_wifi_set_promiscuous_filter(&filter);
+}
+
+void CaptureFilter::setSubtypeMask(uint16_t mask) {
+    subtypeMask = mask & DEFAULT_SUBTYPE_MASK;
+}
+
+uint16_t CaptureFilter::getSubtypeMask() {
+    return subtypeMask;
+}
+
+bool CaptureFilter::accept(wifi_promiscuous_pkt_type_t type, const uint8_t* frame,
+                           size_t length, uint8_t channel) {
+    if (channel > MAX_CHANNEL) channel = 0;
+
+    bool pass = type == WIFI_PKT_MGMT &&
+                length >= WiFiFrameParser::HEADER_LENGTH + WiFiFrameParser::FCS_LENGTH &&
+                (subtypeMask & (1 << WiFiFrameParser::frameSubtype(frame)));
+
+    // Only the WiFi driver task writes these, so plain increments are safe.
+    if (pass) {
+        acceptedFrames[channel]++;
+    } else {
+        rejectedFrames[channel]++;
+    }
+    return pass;
+}
+
+CaptureFilter::ChannelCounters CaptureFilter::getChannelCounters(uint8_t channel) {
+    ChannelCounters counters = {0, 0};
+    if (channel <= MAX_CHANNEL) {
+        counters.accepted = acceptedFrames[channel];
+        counters.rejected = rejectedFrames[channel];
+    }
+    return counters;
+}
+
+CaptureFilter::ChannelCounters CaptureFilter::getTotalCounters() {
+    ChannelCounters totals = {0, 0};
+    for (uint8_t ch = 0; ch <= MAX_CHANNEL; ch++) {
+        totals.accepted += acceptedFrames[ch];
+        totals.rejected += rejectedFrames[ch];
+    }
+    return totals;
+}
+
+void CaptureFilter::resetCounters() {
+    memset(acceptedFrames, 0, sizeof(acceptedFrames));
+    memset(rejectedFrames, 0, sizeof(rejectedFrames));
+}
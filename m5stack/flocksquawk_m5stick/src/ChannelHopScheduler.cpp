@@ -0,0 +1,192 @@
+#include "ChannelHopScheduler.h"
+
+#include <string.h>
+
+// RoundRobinHopScheduler
+
+RoundRobinHopScheduler::RoundRobinHopScheduler(uint8_t channelCount, uint16_t dwellMs)
+    : channelCount(channelCount > MAX_CHANNELS ? MAX_CHANNELS : channelCount),
+      dwellMs(dwellMs), current(0) {
+    memset(framesSeen, 0, sizeof(framesSeen));
+    memset(matches, 0, sizeof(matches));
+    memset(lastMatchMs, 0, sizeof(lastMatchMs));
+    memset(lastVisitMs, 0, sizeof(lastVisitMs));
+}
+
+ChannelHop RoundRobinHopScheduler::next(uint32_t nowMs) {
+    current++;
+    if (current > channelCount) {
+        current = 1;
+    }
+    lastVisitMs[current] = nowMs;
+
+    ChannelHop hop;
+    hop.channel = current;
+    hop.dwellMs = dwellMs;
+    return hop;
+}
+
+void RoundRobinHopScheduler::recordFrame(uint8_t channel) {
+    if (channel >= 1 && channel <= channelCount) {
+        framesSeen[channel]++;
+    }
+}
+
+void RoundRobinHopScheduler::recordMatch(uint8_t channel, uint32_t nowMs) {
+    if (channel >= 1 && channel <= channelCount) {
+        matches[channel]++;
+        lastMatchMs[channel] = nowMs;
+    }
+}
+
+size_t RoundRobinHopScheduler::getPlan(ChannelPlanEntry* out, size_t maxEntries, uint32_t nowMs) const {
+    (void)nowMs;
+    size_t count = 0;
+    for (uint8_t ch = 1; ch <= channelCount && count < maxEntries; ch++) {
+        ChannelPlanEntry& entry = out[count++];
+        entry.channel = ch;
+        entry.weight = 1;
+        entry.dwellMs = dwellMs;
+        entry.framesSeen = framesSeen[ch];
+        entry.matches = matches[ch];
+        entry.lastMatchMs = lastMatchMs[ch];
+        entry.lastVisitMs = lastVisitMs[ch];
+    }
+    return count;
+}
+
+// AdaptiveHopScheduler
+
+AdaptiveHopScheduler::AdaptiveHopScheduler(uint8_t channelCount)
+    : channelCount(channelCount > MAX_CHANNELS ? MAX_CHANNELS : channelCount),
+      current(0), visitStartMs(0) {
+    memset(channels, 0, sizeof(channels));
+
+    // A channel that falls due just after a full-length dwell has started
+    // waits out that dwell, then at most one short visit to each other due
+    // channel, all of which went due before it did.
+    int32_t others = this->channelCount > 0 ? this->channelCount - 1 : 0;
+    int32_t dueAfter = (int32_t)MAX_REVISIT_MS - MAX_DWELL_MS - others * MIN_DWELL_MS;
+    dueAfterMs = dueAfter > 0 ? (uint32_t)dueAfter : 0;
+}
+
+uint8_t AdaptiveHopScheduler::weightFor(uint8_t channel, uint32_t nowMs) const {
+    const ChannelState& state = channels[channel];
+    uint16_t weight = BASE_WEIGHT;
+
+    if (channel == 1 || channel == 6 || channel == 11) {
+        weight += PRIMARY_CHANNEL_BONUS;
+    }
+
+    // One point per 8 frames/s of management traffic.
+    uint16_t traffic = state.frameRate / 8;
+    weight += traffic > MAX_TRAFFIC_BONUS ? MAX_TRAFFIC_BONUS : traffic;
+
+    uint32_t lastMatch = state.lastMatchMs;
+    if (state.matches > 0 && nowMs - lastMatch < RECENT_MATCH_MS) {
+        uint32_t remaining = RECENT_MATCH_MS - (nowMs - lastMatch);
+        weight += (uint16_t)((uint32_t)MAX_MATCH_BONUS * remaining / RECENT_MATCH_MS);
+    }
+
+    return weight > 0xFF ? 0xFF : (uint8_t)weight;
+}
+
+uint16_t AdaptiveHopScheduler::dwellFor(uint8_t weight) const {
+    uint32_t dwell = MIN_DWELL_MS + (uint32_t)(weight - BASE_WEIGHT) * DWELL_PER_WEIGHT_MS;
+    return dwell > MAX_DWELL_MS ? MAX_DWELL_MS : (uint16_t)dwell;
+}
+
+void AdaptiveHopScheduler::closeVisit(uint32_t nowMs) {
+    if (current == 0) return;
+
+    ChannelState& state = channels[current];
+    uint32_t elapsed = nowMs - visitStartMs;
+    if (elapsed == 0) return;
+
+    uint32_t frames = state.framesSeen - state.framesAtVisitStart;
+    uint32_t rate = frames * 1000 / elapsed;
+    if (rate > 0xFFFF) rate = 0xFFFF;
+
+    // EWMA with alpha = 1/4.
+    state.frameRate = (uint16_t)(((uint32_t)state.frameRate * 3 + rate) / 4);
+}
+
+ChannelHop AdaptiveHopScheduler::next(uint32_t nowMs) {
+    closeVisit(nowMs);
+
+    uint8_t chosen = 0;
+    uint8_t chosenWeight = 0;
+
+    // Starvation guard: the most overdue channel wins outright.
+    uint32_t mostOverdue = 0;
+    for (uint8_t ch = 1; ch <= channelCount; ch++) {
+        if (ch == current) continue;
+        uint32_t sinceVisit = nowMs - channels[ch].lastVisitMs;
+        if (sinceVisit >= dueAfterMs && sinceVisit > mostOverdue) {
+            mostOverdue = sinceVisit;
+            chosen = ch;
+        }
+    }
+    bool channelsDue = chosen != 0;
+
+    // Smooth weighted round-robin: every channel earns its weight in credit,
+    // the richest one is visited and pays back the total.
+    int32_t totalWeight = 0;
+    int32_t bestCredit = 0;
+    uint8_t best = 0;
+    for (uint8_t ch = 1; ch <= channelCount; ch++) {
+        uint8_t weight = weightFor(ch, nowMs);
+        ChannelState& state = channels[ch];
+        state.credit += weight;
+        totalWeight += weight;
+        if (best == 0 || state.credit > bestCredit) {
+            best = ch;
+            bestCredit = state.credit;
+        }
+    }
+
+    if (chosen == 0) {
+        chosen = best;
+    }
+    channels[chosen].credit -= totalWeight;
+    chosenWeight = weightFor(chosen, nowMs);
+
+    current = chosen;
+    visitStartMs = nowMs;
+    channels[chosen].lastVisitMs = nowMs;
+    channels[chosen].framesAtVisitStart = channels[chosen].framesSeen;
+
+    ChannelHop hop;
+    hop.channel = chosen;
+    hop.dwellMs = channelsDue ? MIN_DWELL_MS : dwellFor(chosenWeight);
+    return hop;
+}
+
+void AdaptiveHopScheduler::recordFrame(uint8_t channel) {
+    if (channel >= 1 && channel <= channelCount) {
+        channels[channel].framesSeen = channels[channel].framesSeen + 1;
+    }
+}
+
+void AdaptiveHopScheduler::recordMatch(uint8_t channel, uint32_t nowMs) {
+    if (channel >= 1 && channel <= channelCount) {
+        channels[channel].lastMatchMs = nowMs;
+        channels[channel].matches = channels[channel].matches + 1;
+    }
+}
+
+size_t AdaptiveHopScheduler::getPlan(ChannelPlanEntry* out, size_t maxEntries, uint32_t nowMs) const {
+    size_t count = 0;
+    for (uint8_t ch = 1; ch <= channelCount && count < maxEntries; ch++) {
+        const ChannelState& state = channels[ch];
+        ChannelPlanEntry& entry = out[count++];
+        entry.channel = ch;
+        entry.weight = weightFor(ch, nowMs);
+        entry.dwellMs = dwellFor(entry.weight);
+        entry.framesSeen = state.framesSeen;
+        entry.matches = state.matches;
+        entry.lastMatchMs = state.lastMatchMs;
+        entry.lastVisitMs = state.lastVisitMs;
+    }
+    return count;
+}
@@ -0,0 +1,155 @@
+#include "CuckooFilter.h"
+
+#include <string.h>
+
+static const uint16_t EMPTY = 0;
+
+CuckooFilter::CuckooFilter(uint16_t* buckets, size_t bucketCount)
+    : buckets(buckets), bucketCount(bucketCount), count(0), kickState(0x9E3779B9u) {
+    clear();
+}
+
+void CuckooFilter::clear() {
+    memset(buckets, 0, bucketCount * SLOTS * sizeof(uint16_t));
+    count = 0;
+}
+
+uint32_t CuckooFilter::hashMac(const uint8_t* mac) {
+    uint32_t low = ((uint32_t)mac[2] << 24) | ((uint32_t)mac[3] << 16) | ((uint32_t)mac[4] << 8) | mac[5];
+    uint32_t high = ((uint32_t)mac[0] << 8) | mac[1];
+    uint32_t h = low * 0x85EBCA6Bu ^ high * 0xC2B2AE35u;
+    h ^= h >> 16;
+    h *= 0x7FEB352Du;
+    h ^= h >> 15;
+    h *= 0x846CA68Bu;
+    return h ^ (h >> 16);
+}
+
+// Upper half of the hash, never 0 since 0 marks an empty slot.
+uint16_t CuckooFilter::fingerprintOf(uint32_t hash) {
+    uint16_t fingerprint = (uint16_t)(hash >> 16);
+    return fingerprint ? fingerprint : 1;
+}
+
+// Symmetric, so either bucket of a pair leads to the other using only the
+// fingerprint, which is all that is left once an entry is stored.
+size_t CuckooFilter::altIndex(size_t index, uint16_t fingerprint) const {
+    return (index ^ ((uint32_t)fingerprint * 0x5BD1E995u >> 8)) & (bucketCount - 1);
+}
+
+bool CuckooFilter::bucketContains(size_t index, uint16_t fingerprint) const {
+    const uint16_t* bucket = &buckets[index * SLOTS];
+    for (uint8_t slot = 0; slot < SLOTS; slot++) {
+        if (bucket[slot] == fingerprint) return true;
+    }
+    return false;
+}
+
+int8_t CuckooFilter::freeSlot(size_t index) const {
+    const uint16_t* bucket = &buckets[index * SLOTS];
+    for (uint8_t slot = 0; slot < SLOTS; slot++) {
+        if (bucket[slot] == EMPTY) return slot;
+    }
+    return -1;
+}
+
+// What a slot will hold once the first `moveCount` moves are applied.
+uint16_t CuckooFilter::plannedSlot(const Move* moves, size_t moveCount, size_t index, uint8_t slot) const {
+    for (size_t i = moveCount; i > 0; i--) {
+        if (moves[i - 1].index == index && moves[i - 1].slot == slot) return moves[i - 1].fingerprint;
+    }
+    return buckets[index * SLOTS + slot];
+}
+
+bool CuckooFilter::bucketRemove(size_t index, uint16_t fingerprint) {
+    uint16_t* bucket = &buckets[index * SLOTS];
+    for (uint8_t slot = 0; slot < SLOTS; slot++) {
+        if (bucket[slot] == fingerprint) {
+            bucket[slot] = EMPTY;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool CuckooFilter::contains(const uint8_t* mac) const {
+    uint32_t hash = hashMac(mac);
+    uint16_t fingerprint = fingerprintOf(hash);
+    size_t index = hash & (bucketCount - 1);
+    return bucketContains(index, fingerprint) || bucketContains(altIndex(index, fingerprint), fingerprint);
+}
+
+size_t CuckooFilter::planInsert(const uint8_t* mac, Move* moves) {
+    uint32_t hash = hashMac(mac);
+    uint16_t fingerprint = fingerprintOf(hash);
+    size_t index = hash & (bucketCount - 1);
+    int8_t slot = freeSlot(index);
+    if (slot < 0) {
+        index = altIndex(index, fingerprint);
+        slot = freeSlot(index);
+    }
+    if (slot >= 0) {
+        moves[0].index = (uint16_t)index;
+        moves[0].slot = (uint8_t)slot;
+        moves[0].fingerprint = fingerprint;
+        return 1;
+    }
+
+    // Both buckets full: plan an eviction along a random walk. The walk
+    // only ever displaces into occupied slots, so free slots can be read
+    // from the table; a displaced slot is read back from the plan.
+    uint16_t carried = fingerprint;
+    if (!(kickState & 1)) index = altIndex(index, fingerprint);
+
+    for (uint16_t kick = 0; kick < MAX_KICKS; kick++) {
+        kickState ^= kickState << 13;
+        kickState ^= kickState >> 17;
+        kickState ^= kickState << 5;
+        uint8_t victim = kickState % SLOTS;
+
+        uint16_t displaced = plannedSlot(moves, kick, index, victim);
+        moves[kick].index = (uint16_t)index;
+        moves[kick].slot = victim;
+        moves[kick].fingerprint = carried;
+        carried = displaced;
+
+        index = altIndex(index, carried);
+        slot = freeSlot(index);
+        if (slot >= 0) {
+            moves[kick + 1].index = (uint16_t)index;
+            moves[kick + 1].slot = (uint8_t)slot;
+            moves[kick + 1].fingerprint = carried;
+            return kick + 2;
+        }
+    }
+    return 0;
+}
+
+void CuckooFilter::commitInsert(const Move* moves, size_t moveCount) {
+    if (moveCount == 0) return;
+    for (size_t i = 0; i < moveCount; i++) {
+        buckets[moves[i].index * SLOTS + moves[i].slot] = moves[i].fingerprint;
+    }
+    count++;
+}
+
+bool CuckooFilter::remove(const uint8_t* mac) {
+    uint32_t hash = hashMac(mac);
+    uint16_t fingerprint = fingerprintOf(hash);
+    size_t index = hash & (bucketCount - 1);
+    if (bucketRemove(index, fingerprint) || bucketRemove(altIndex(index, fingerprint), fingerprint)) {
+        count--;
+        return true;
+    }
+    return false;
+}
+
+bool CuckooFilter::restore(const uint16_t* table, size_t tableBucketCount) {
+    if (tableBucketCount != bucketCount) return false;
+    memcpy(buckets, table, bucketCount * SLOTS * sizeof(uint16_t));
+    count = 0;
+    for (size_t i = 0; i < bucketCount * SLOTS; i++) {
+        if (buckets[i] != EMPTY) count++;
+    }
+    return true;
+}
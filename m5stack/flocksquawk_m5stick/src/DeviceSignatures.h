@@ -2,50 +2,119 @@
 #define DEVICE_SIGNATURES_H
 
 #include <Arduino.h>
+#include "OuiTable.h"
+#include "UuidSet.h"
+#include "SignatureDatabase.h"
+
+// Generated by tools/sigcompile from tools/sigcompile/signatures.csv.
+// Edit the CSV and run `make headers` there instead of editing this file.
 
 namespace DeviceProfiles {
-    
-    // Network name patterns for target identification
+
+    // Network name patterns for target identification (case-insensitive substrings)
     const char* const NetworkNames[] = {
-        "flock",
-        "Flock", 
-        "FLOCK",
+        "flock",           // Substring; also hits unrelated names containing flock
         "FS Ext Battery",
-        "Penguin",
-        "Pigvision",
+        "Penguin",         // Common word; needs a second match to alert
+        "Pigvision"
+    };
+    const size_t NetworkNameCount = 4;
+    const SignatureInfo NetworkNameInfo[] = {
+        {80, SignatureSet::SURVEILLANCE_DEVICE},
+        {90, SignatureSet::SURVEILLANCE_DEVICE},
+        {50, SignatureSet::SURVEILLANCE_DEVICE},
+        {85, SignatureSet::SURVEILLANCE_DEVICE}
     };
-    const size_t NetworkNameCount = sizeof(NetworkNames) / sizeof(NetworkNames[0]);
 
-    // MAC address OUI prefixes for target devices
-    const char* const MACPrefixes[] = {
-        "58:8e:81", "cc:cc:cc", "ec:1b:bd", "90:35:ea", "04:0d:84",
-        "f0:82:c0", "1c:34:f1", "38:5b:44", "94:34:69", "b4:e3:f9",
-        "70:c9:4e", "3c:91:80", "d8:f3:bc", "80:30:49", "14:5a:fc",
-        "74:4c:a1", "08:3a:88", "9c:2f:9d", "94:08:53", "e4:aa:ea"
+    // MAC address OUI prefixes for target devices, as 0xAABBCC for aa:bb:cc.
+    // Must stay sorted ascending; the static_assert below rejects the build otherwise.
+    constexpr uint32_t MACPrefixes[] = {
+        0x040d84,
+        0x083a88,
+        0x145afc,
+        0x1c34f1,
+        0x385b44,
+        0x3c9180,
+        0x588e81,
+        0x70c94e,
+        0x744ca1,
+        0x803049,
+        0x9035ea,
+        0x940853,
+        0x943469,
+        0x9c2f9d,
+        0xb4e3f9,
+        0xcccccc,  // Not a vendor-assigned prefix
+        0xd8f3bc,
+        0xe4aaea,
+        0xec1bbd,
+        0xf082c0
+    };
+    const size_t MACPrefixCount = 20;
+    static_assert(OuiTable::isSorted(MACPrefixes, MACPrefixCount),
+                  "DeviceProfiles::MACPrefixes must be sorted ascending without duplicates");
+    constexpr OuiTable MACPrefixTable(MACPrefixes, MACPrefixCount);
+    const SignatureInfo MACPrefixInfo[] = {
+        {45, SignatureSet::SURVEILLANCE_DEVICE},
+        {45, SignatureSet::SURVEILLANCE_DEVICE},
+        {45, SignatureSet::SURVEILLANCE_DEVICE},
+        {45, SignatureSet::SURVEILLANCE_DEVICE},
+        {45, SignatureSet::SURVEILLANCE_DEVICE},
+        {45, SignatureSet::SURVEILLANCE_DEVICE},
+        {45, SignatureSet::SURVEILLANCE_DEVICE},
+        {45, SignatureSet::SURVEILLANCE_DEVICE},
+        {45, SignatureSet::SURVEILLANCE_DEVICE},
+        {45, SignatureSet::SURVEILLANCE_DEVICE},
+        {45, SignatureSet::SURVEILLANCE_DEVICE},
+        {45, SignatureSet::SURVEILLANCE_DEVICE},
+        {45, SignatureSet::SURVEILLANCE_DEVICE},
+        {45, SignatureSet::SURVEILLANCE_DEVICE},
+        {45, SignatureSet::SURVEILLANCE_DEVICE},
+        {30, SignatureSet::SURVEILLANCE_DEVICE},
+        {45, SignatureSet::SURVEILLANCE_DEVICE},
+        {45, SignatureSet::SURVEILLANCE_DEVICE},
+        {45, SignatureSet::SURVEILLANCE_DEVICE},
+        {45, SignatureSet::SURVEILLANCE_DEVICE}
     };
-    const size_t MACPrefixCount = sizeof(MACPrefixes) / sizeof(MACPrefixes[0]);
 
-    // Bluetooth device name patterns
+    // Bluetooth device name patterns (case-insensitive substrings)
     const char* const BLEIdentifiers[] = {
         "FS Ext Battery",
-        "Penguin",
+        "Penguin",         // Common word; needs a second match to alert
         "Flock",
         "Pigvision"
     };
-    const size_t BLEIdentifierCount = sizeof(BLEIdentifiers) / sizeof(BLEIdentifiers[0]);
+    const size_t BLEIdentifierCount = 4;
+    const SignatureInfo BLEIdentifierInfo[] = {
+        {90, SignatureSet::SURVEILLANCE_DEVICE},
+        {50, SignatureSet::SURVEILLANCE_DEVICE},
+        {80, SignatureSet::SURVEILLANCE_DEVICE},
+        {85, SignatureSet::SURVEILLANCE_DEVICE}
+    };
 
-    // Raven acoustic detection device service UUIDs
-    const char* const RavenServices[] = {
-        "0000180a-0000-1000-8000-00805f9b34fb",  // Device info (all versions)
-        "00003100-0000-1000-8000-00805f9b34fb",  // GPS (1.2.0+)
-        "00003200-0000-1000-8000-00805f9b34fb",  // Power/Battery (1.2.0+)
-        "00003300-0000-1000-8000-00805f9b34fb",  // Network (1.2.0+)
-        "00003400-0000-1000-8000-00805f9b34fb",  // Upload stats (1.2.0+)
-        "00003500-0000-1000-8000-00805f9b34fb",  // Error tracking (1.2.0+)
-        "00001809-0000-1000-8000-00805f9b34fb",  // Health/Temp (legacy 1.1.7)
-        "00001819-0000-1000-8000-00805f9b34fb"   // Location (legacy 1.1.7)
+    // Raven acoustic detection device service UUIDs, converted to binary at
+    // compile time. ThreatAnalyzer matches base UUIDs by their 16-bit alias.
+    constexpr Uuid128 RavenServices[] = {
+        Uuid128::parse("0000180a-0000-1000-8000-00805f9b34fb"),  // Device info (all versions); standard service on most BLE devices
+        Uuid128::parse("00003100-0000-1000-8000-00805f9b34fb"),  // GPS (1.2.0+)
+        Uuid128::parse("00003200-0000-1000-8000-00805f9b34fb"),  // Power/Battery (1.2.0+)
+        Uuid128::parse("00003300-0000-1000-8000-00805f9b34fb"),  // Network (1.2.0+)
+        Uuid128::parse("00003400-0000-1000-8000-00805f9b34fb"),  // Upload stats (1.2.0+)
+        Uuid128::parse("00003500-0000-1000-8000-00805f9b34fb"),  // Error tracking (1.2.0+)
+        Uuid128::parse("00001809-0000-1000-8000-00805f9b34fb"),  // Health/Temp (legacy 1.1.7); standard SIG service
+        Uuid128::parse("00001819-0000-1000-8000-00805f9b34fb")   // Location (legacy 1.1.7); standard SIG service
+    };
+    const size_t RavenServiceCount = 8;
+    const SignatureInfo RavenServiceInfo[] = {
+        {20, SignatureSet::ACOUSTIC_DETECTOR},
+        {90, SignatureSet::ACOUSTIC_DETECTOR},
+        {90, SignatureSet::ACOUSTIC_DETECTOR},
+        {90, SignatureSet::ACOUSTIC_DETECTOR},
+        {90, SignatureSet::ACOUSTIC_DETECTOR},
+        {90, SignatureSet::ACOUSTIC_DETECTOR},
+        {35, SignatureSet::ACOUSTIC_DETECTOR},
+        {35, SignatureSet::ACOUSTIC_DETECTOR}
     };
-    const size_t RavenServiceCount = sizeof(RavenServices) / sizeof(RavenServices[0]);
 }
 
 #endif
@@ -0,0 +1,59 @@
+#ifndef EVENT_TOPIC_H
+#define EVENT_TOPIC_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Subscriber list for one event type: up to Capacity plain function
+// pointers in an inline array, called in subscription order. No heap and no
+// type erasure, so a publish is a loop of indirect calls, and a topic with
+// static storage is zero-initialized before setup() runs. Captureless
+// lambdas convert to Handler, so subscribing looks the same as it did with
+// std::function; state lives in the globals the handlers already use.
+//
+// Subscribe during setup, before the tasks that publish start. Publishing
+// is safe from any task once the list stops changing; subscribe() itself
+// is not synchronized.
+template <uint8_t Capacity, typename... Args>
+class EventTopic {
+    static_assert(Capacity >= 1, "EventTopic needs room for a subscriber");
+
+public:
+    typedef void (*Handler)(Args...);
+
+    constexpr EventTopic() : handlers(), count(0) {}
+
+    // False if the topic is full or the handler is already subscribed.
+    bool subscribe(Handler handler) {
+        if (!handler || count >= Capacity) return false;
+        for (uint8_t i = 0; i < count; i++) {
+            if (handlers[i] == handler) return false;
+        }
+        handlers[count++] = handler;
+        return true;
+    }
+
+    bool unsubscribe(Handler handler) {
+        for (uint8_t i = 0; i < count; i++) {
+            if (handlers[i] != handler) continue;
+            for (uint8_t j = i + 1; j < count; j++) handlers[j - 1] = handlers[j];
+            handlers[--count] = nullptr;
+            return true;
+        }
+        return false;
+    }
+
+    void publish(Args... args) const {
+        for (uint8_t i = 0; i < count; i++) handlers[i](args...);
+    }
+
+    bool empty() const { return count == 0; }
+    uint8_t size() const { return count; }
+    static uint8_t capacity() { return Capacity; }
+
+private:
+    Handler handlers[Capacity];
+    uint8_t count;
+};
+
+#endif
@@ -0,0 +1,170 @@
+#include "NameMatcher.h"
+
+#include <string.h>
+
+static uint8_t foldCase(uint8_t c) {
+    return (c >= 'A' && c <= 'Z') ? (uint8_t)(c + ('a' - 'A')) : c;
+}
+
+// Assigns a class to every folded byte used by the patterns, writing the
+// 256-entry map to `classMap` when given. Returns the row width, or 0 if the
+// patterns use more distinct bytes than fit.
+static size_t assignClasses(const char* const* patterns, size_t count, uint8_t* classMap) {
+    uint8_t local[256];
+    uint8_t* map = classMap ? classMap : local;
+    memset(map, 0, 256);
+
+    size_t classes = 1;
+    for (size_t i = 0; i < count; i++) {
+        if (!patterns[i]) continue;
+        for (const uint8_t* p = (const uint8_t*)patterns[i]; *p; p++) {
+            uint8_t folded = foldCase(*p);
+            if (map[folded] != 0) continue;
+            if (classes > 0xFF) return 0;
+            map[folded] = (uint8_t)classes;
+            if (folded >= 'a' && folded <= 'z') map[folded - ('a' - 'A')] = (uint8_t)classes;
+            classes++;
+        }
+    }
+    return classes;
+}
+
+// Upper bound on states: the root plus one per pattern byte.
+static size_t maxStates(const char* const* patterns, size_t count) {
+    size_t states = 1;
+    for (size_t i = 0; i < count; i++) {
+        if (patterns[i]) states += strlen(patterns[i]);
+    }
+    return states;
+}
+
+size_t NameMatcher::requiredBytes(const char* const* patterns, size_t count) {
+    size_t classes = assignClasses(patterns, count, nullptr);
+    size_t states = maxStates(patterns, count);
+    if (classes == 0 || states > 0xFFFF || count >= NameAutomaton::NO_PATTERN) return 0;
+
+    // transitions, firstPattern, outputLink, plus fail links and the BFS
+    // queue as build scratch, then nextPattern and the class map.
+    return sizeof(uint16_t) * (states * classes + states * 4 + count) + 256;
+}
+
+bool NameMatcher::build(const char* const* patterns, size_t count,
+                        void* buffer, size_t bufferSize, NameAutomaton& out) {
+    memset(&out, 0, sizeof(out));
+    size_t needed = requiredBytes(patterns, count);
+    if (needed == 0 || !buffer || bufferSize < needed || ((uintptr_t)buffer & 1)) return false;
+
+    size_t states = maxStates(patterns, count);
+    uint16_t* transitions = (uint16_t*)buffer;
+    uint8_t* charClass = (uint8_t*)buffer + needed - 256;
+    size_t classes = assignClasses(patterns, count, charClass);
+    uint16_t* firstPattern = transitions + states * classes;
+    uint16_t* outputLink = firstPattern + states;
+    uint16_t* fail = outputLink + states;
+    uint16_t* queue = fail + states;
+    uint16_t* nextPattern = queue + states;
+
+    memset(transitions, 0, sizeof(uint16_t) * states * classes);
+    memset(firstPattern, 0xFF, sizeof(uint16_t) * states);
+    memset(outputLink, 0, sizeof(uint16_t) * states);
+    memset(fail, 0, sizeof(uint16_t) * states);
+
+    // Trie. No edge ever leads back to the root, so 0 doubles as "no edge".
+    uint16_t used = 1;
+    for (size_t i = 0; i < count; i++) {
+        nextPattern[i] = NameAutomaton::NO_PATTERN;
+        if (!patterns[i] || !patterns[i][0]) continue;
+
+        uint16_t state = 0;
+        for (const uint8_t* p = (const uint8_t*)patterns[i]; *p; p++) {
+            uint16_t& edge = transitions[(size_t)state * classes + charClass[*p]];
+            if (edge == 0) edge = used++;
+            state = edge;
+        }
+        nextPattern[i] = firstPattern[state];
+        firstPattern[state] = (uint16_t)i;
+    }
+
+    // Breadth-first pass: fill failure links and replace every missing edge
+    // with the failure state's edge, turning the trie into a full DFA.
+    size_t head = 0;
+    size_t tail = 0;
+    for (size_t c = 1; c < classes; c++) {
+        uint16_t child = transitions[c];
+        if (child != 0) queue[tail++] = child;
+    }
+    while (head < tail) {
+        uint16_t state = queue[head++];
+        uint16_t* row = transitions + (size_t)state * classes;
+        const uint16_t* failRow = transitions + (size_t)fail[state] * classes;
+
+        for (size_t c = 0; c < classes; c++) {
+            uint16_t child = row[c];
+            if (child == 0) {
+                row[c] = failRow[c];
+                continue;
+            }
+            uint16_t link = failRow[c];
+            fail[child] = link;
+            outputLink[child] = (firstPattern[link] != NameAutomaton::NO_PATTERN) ? link : outputLink[link];
+            queue[tail++] = child;
+        }
+    }
+
+    out.stateCount = used;
+    out.classCount = (uint16_t)classes;
+    out.patternCount = (uint16_t)count;
+    out.charClass = charClass;
+    out.transitions = transitions;
+    out.firstPattern = firstPattern;
+    out.outputLink = outputLink;
+    out.nextPattern = nextPattern;
+    return true;
+}
+
+size_t NameMatcher::scan(const char* text, size_t length, uint16_t* hits, size_t maxHits) const {
+    if (!text || !isReady()) return 0;
+
+    size_t found = 0;
+    uint16_t state = 0;
+    for (size_t i = 0; i < length && found < maxHits; i++) {
+        state = step(state, (uint8_t)text[i]);
+
+        uint16_t match = (automaton.firstPattern[state] != NameAutomaton::NO_PATTERN)
+                       ? state : automaton.outputLink[state];
+        for (; match != 0; match = automaton.outputLink[match]) {
+            for (uint16_t id = automaton.firstPattern[match];
+                 id != NameAutomaton::NO_PATTERN && found < maxHits;
+                 id = automaton.nextPattern[id]) {
+                bool seen = false;
+                for (size_t j = 0; j < found; j++) {
+                    if (hits[j] == id) { seen = true; break; }
+                }
+                if (!seen) hits[found++] = id;
+            }
+        }
+    }
+    return found;
+}
+
+size_t NameMatcher::scan(const char* text, uint16_t* hits, size_t maxHits) const {
+    return text ? scan(text, strlen(text), hits, maxHits) : 0;
+}
+
+bool NameMatcher::matchesAny(const char* text, size_t length) const {
+    if (!text || !isReady()) return false;
+
+    uint16_t state = 0;
+    for (size_t i = 0; i < length; i++) {
+        state = step(state, (uint8_t)text[i]);
+        if (automaton.firstPattern[state] != NameAutomaton::NO_PATTERN ||
+            automaton.outputLink[state] != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool NameMatcher::matchesAny(const char* text) const {
+    return text ? matchesAny(text, strlen(text)) : false;
+}
@@ -0,0 +1,64 @@
+#ifndef NAME_MATCHER_H
+#define NAME_MATCHER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Aho-Corasick automaton over ASCII-case-folded name patterns, stored as a
+// dense DFA. Input bytes are first mapped through `charClass` (which also
+// does the case folding), so a row holds one entry per character actually
+// used by the patterns instead of 256. Every field is a plain pointer, so the
+// same layout works for tables built in RAM at boot and for const arrays
+// emitted ahead of time into flash.
+struct NameAutomaton {
+    static const uint16_t NO_PATTERN = 0xFFFF;
+
+    uint16_t stateCount;
+    uint16_t classCount;              // Row width; class 0 = byte not in any pattern
+    uint16_t patternCount;
+    const uint8_t* charClass;         // [256] raw byte -> class
+    const uint16_t* transitions;      // [stateCount * classCount] next state
+    const uint16_t* firstPattern;     // [stateCount] first pattern ending here, or NO_PATTERN
+    const uint16_t* outputLink;       // [stateCount] nearest proper suffix state with output, 0 = none
+    const uint16_t* nextPattern;      // [patternCount] next pattern ending in the same state
+};
+
+// Scans a string once and reports every pattern that occurs anywhere in it,
+// regardless of how many patterns the automaton holds. The automaton itself
+// is not owned.
+class NameMatcher {
+public:
+    NameMatcher() : automaton() {}
+    explicit NameMatcher(const NameAutomaton& automaton) : automaton(automaton) {}
+
+    // Builds an automaton for `patterns` into `buffer`, which must hold
+    // requiredBytes(patterns, count) bytes and stay alive as long as the
+    // matcher. Empty patterns never match. Returns false if the buffer is too
+    // small or the patterns exceed the 16-bit state/pattern limits.
+    static size_t requiredBytes(const char* const* patterns, size_t count);
+    static bool build(const char* const* patterns, size_t count,
+                      void* buffer, size_t bufferSize, NameAutomaton& out);
+
+    // Writes the distinct ids (indices into the pattern list) of the patterns
+    // found in `text` to `hits`, up to `maxHits`, and returns how many were
+    // written. Duplicate spellings such as "flock" and "FLOCK" both report.
+    size_t scan(const char* text, size_t length, uint16_t* hits, size_t maxHits) const;
+    size_t scan(const char* text, uint16_t* hits, size_t maxHits) const;
+
+    // Stops at the first hit.
+    bool matchesAny(const char* text, size_t length) const;
+    bool matchesAny(const char* text) const;
+
+    bool isReady() const { return automaton.stateCount > 0; }
+    size_t patternCount() const { return automaton.patternCount; }
+    const NameAutomaton& getAutomaton() const { return automaton; }
+
+private:
+    NameAutomaton automaton;
+
+    uint16_t step(uint16_t state, uint8_t byte) const {
+        return automaton.transitions[(size_t)state * automaton.classCount + automaton.charClass[byte]];
+    }
+};
+
+#endif
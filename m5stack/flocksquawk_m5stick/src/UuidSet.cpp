@@ -0,0 +1,105 @@
+#include "UuidSet.h"
+
+#include <string.h>
+
+// Bytes 0-11 of the Bluetooth Base UUID, little-endian; 12-15 carry the alias.
+static const uint8_t BASE_UUID_PREFIX_LE[12] = {
+    0xfb, 0x34, 0x9b, 0x5f, 0x80, 0x00, 0x00, 0x80,
+    0x00, 0x10, 0x00, 0x00
+};
+
+// At least two slots per entry keeps probe chains short.
+static size_t slotCountFor(size_t count) {
+    size_t slots = 2;
+    while (slots < count * 2) slots <<= 1;
+    return slots;
+}
+
+bool UuidSet::isBaseUuid(const uint8_t* uuid) {
+    return uuid[14] == 0 && uuid[15] == 0 &&
+           memcmp(uuid, BASE_UUID_PREFIX_LE, sizeof(BASE_UUID_PREFIX_LE)) == 0;
+}
+
+uint16_t UuidSet::hash16(uint16_t uuid) {
+    return (uint16_t)(((uint32_t)uuid * 2654435761u) >> 16);
+}
+
+uint32_t UuidSet::hash128(const uint8_t* uuid) {
+    uint32_t h = 0;
+    for (uint8_t i = 0; i < 16; i += 4) {
+        h ^= (uint32_t)uuid[i] | ((uint32_t)uuid[i + 1] << 8) |
+             ((uint32_t)uuid[i + 2] << 16) | ((uint32_t)uuid[i + 3] << 24);
+        h *= 2654435761u;
+    }
+    return h ^ (h >> 16);
+}
+
+size_t UuidSet::requiredBytes(size_t count) {
+    if (count == 0 || count >= 0x8000) return 0;
+    return 2 * slotCountFor(count) * sizeof(uint16_t);
+}
+
+bool UuidSet::build(const Uuid128* uuids, size_t count,
+                    void* buffer, size_t bufferSize, UuidSetTable& out) {
+    memset(&out, 0, sizeof(out));
+    size_t needed = requiredBytes(count);
+    if (needed == 0 || !uuids || !buffer || bufferSize < needed || ((uintptr_t)buffer & 1)) return false;
+
+    size_t slots = slotCountFor(count);
+    uint16_t* aliasSlots = (uint16_t*)buffer;
+    uint16_t* fullSlots = aliasSlots + slots;
+    memset(buffer, 0, needed);
+
+    out.entryCount = (uint16_t)count;
+    out.slotMask = (uint16_t)(slots - 1);
+    out.entries = uuids;
+    out.aliasSlots = aliasSlots;
+    out.fullSlots = fullSlots;
+
+    UuidSet view(out);
+    for (size_t i = 0; i < count; i++) {
+        const uint8_t* uuid = uuids[i].bytes;
+        if (view.find(uuid) != NOT_FOUND) continue;  // Duplicate; first entry wins
+
+        bool alias = isBaseUuid(uuid);
+        uint16_t* table = alias ? aliasSlots : fullSlots;
+        size_t slot = (alias ? hash16(shortAlias(uuid)) : hash128(uuid)) & out.slotMask;
+        while (table[slot] != 0) slot = (slot + 1) & out.slotMask;
+        table[slot] = (uint16_t)(i + 1);
+    }
+    return true;
+}
+
+int UuidSet::find(uint16_t uuid16) const {
+    if (!isReady()) return NOT_FOUND;
+
+    for (size_t slot = hash16(uuid16) & table.slotMask; ; slot = (slot + 1) & table.slotMask) {
+        uint16_t entry = table.aliasSlots[slot];
+        if (entry == 0) return NOT_FOUND;
+        if (shortAlias(table.entries[entry - 1].bytes) == uuid16) return entry - 1;
+    }
+}
+
+int UuidSet::find(const uint8_t* uuid128) const {
+    if (!isReady() || !uuid128) return NOT_FOUND;
+    if (isBaseUuid(uuid128)) return find(shortAlias(uuid128));
+
+    for (size_t slot = hash128(uuid128) & table.slotMask; ; slot = (slot + 1) & table.slotMask) {
+        uint16_t entry = table.fullSlots[slot];
+        if (entry == 0) return NOT_FOUND;
+        if (memcmp(table.entries[entry - 1].bytes, uuid128, 16) == 0) return entry - 1;
+    }
+}
+
+int UuidSet::findAny(const uint16_t* uuid16, size_t uuid16Count,
+                     const uint8_t (*uuid128)[16], size_t uuid128Count) const {
+    for (size_t i = 0; i < uuid16Count; i++) {
+        int match = find(uuid16[i]);
+        if (match != NOT_FOUND) return match;
+    }
+    for (size_t i = 0; i < uuid128Count; i++) {
+        int match = find(uuid128[i]);
+        if (match != NOT_FOUND) return match;
+    }
+    return NOT_FOUND;
+}
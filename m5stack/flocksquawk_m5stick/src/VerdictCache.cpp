@@ -0,0 +1,85 @@
+#include "VerdictCache.h"
+
+#include <string.h>
+
+static_assert((VerdictCache::CAPACITY & (VerdictCache::CAPACITY - 1)) == 0,
+              "CAPACITY must be a power of two");
+
+static uint32_t mixWord(uint32_t h, uint32_t word) {
+    h ^= word;
+    h *= 0x9E3779B1u;
+    return (h << 13) | (h >> 19);
+}
+
+VerdictCache::VerdictCache() : ttlMs(DEFAULT_TTL_MS) {
+    memset(entries, 0, sizeof(entries));
+    memset(&stats, 0, sizeof(stats));
+}
+
+VerdictCache::Key VerdictCache::makeKey(const uint8_t* mac, const char* ssid, size_t ssidLength) {
+    Key key;
+    memcpy(key.mac, mac, 6);
+    key.ssidLength = (uint8_t)(ssidLength > 32 ? 32 : ssidLength);
+
+    // Four bytes per step; this runs on every frame, so it has to stay well
+    // below the cost of the matchers it saves.
+    uint32_t h = 0x811C9DC5u ^ key.ssidLength;
+    size_t i = 0;
+    for (; i + 4 <= key.ssidLength; i += 4) {
+        uint32_t word;
+        memcpy(&word, ssid + i, 4);
+        h = mixWord(h, word);
+    }
+    if (i < key.ssidLength) {
+        uint32_t word = 0;
+        memcpy(&word, ssid + i, key.ssidLength - i);
+        h = mixWord(h, word);
+    }
+    key.ssidHash = h;
+
+    uint32_t macLow;
+    memcpy(&macLow, mac + 2, 4);
+    uint32_t slot = (macLow ^ ((uint32_t)mac[0] << 8 | mac[1]) ^ h) * 0x85EBCA6Bu;
+    key.slot = (slot >> 16) & (CAPACITY - 1);
+    return key;
+}
+
+bool VerdictCache::lookup(const Key& key, uint32_t nowMs, WiFiVerdict& out) {
+    const Entry& entry = entries[key.slot];
+    if (ttlMs == 0 || !entry.valid || entry.ssidHash != key.ssidHash ||
+        entry.ssidLength != key.ssidLength || memcmp(entry.mac, key.mac, 6) != 0) {
+        stats.misses++;
+        return false;
+    }
+    if (nowMs - entry.storedMs >= ttlMs) {
+        stats.misses++;
+        stats.expired++;
+        return false;
+    }
+    stats.hits++;
+    out = entry.verdict;
+    return true;
+}
+
+void VerdictCache::store(const Key& key, uint32_t nowMs, const WiFiVerdict& verdict) {
+    if (ttlMs == 0) return;
+
+    Entry& entry = entries[key.slot];
+    if (entry.valid && nowMs - entry.storedMs < ttlMs &&
+        (entry.ssidHash != key.ssidHash || memcmp(entry.mac, key.mac, 6) != 0)) {
+        stats.replaced++;
+    }
+    memcpy(entry.mac, key.mac, 6);
+    entry.ssidLength = key.ssidLength;
+    entry.valid = true;
+    entry.ssidHash = key.ssidHash;
+    entry.storedMs = nowMs;
+    entry.verdict = verdict;
+}
+
+void VerdictCache::clear() {
+    for (size_t i = 0; i < CAPACITY; i++) {
+        entries[i].valid = false;
+    }
+    stats.invalidations++;
+}
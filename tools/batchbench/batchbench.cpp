@@ -0,0 +1,268 @@
+// batchbench - host throughput of the analyzer's signature stages.
+//
+// Compares matching one frame at a time (OUI probe then name scan, frame by
+// frame, as ThreatAnalyzer did before batching) with BatchMatcher's staged
+// passes at several batch sizes, over the same synthetic capture. Tables
+// come from a signatures.bin built by sigcompile, parsed with the firmware's
+// own SignatureDatabase. Host caches and branch predictors are far larger
+// than the ESP32's, so treat the numbers as relative, not absolute.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "SignatureDatabase.h"
+#include "BatchMatcher.h"
+
+// Field-compatible with the firmware's WiFiFrameEvent and BluetoothDeviceEvent
+// (src/EventBus.h), which need Arduino.h and cannot be included here.
+struct WiFiFrameEvent {
+    uint8_t mac[6];
+    char ssid[33];
+    int8_t rssi;
+    uint8_t channel;
+    uint8_t frameSubtype;
+    uint8_t dsChannel;
+    uint8_t rateCount;
+    bool hasHTCapabilities;
+    bool hasVHTCapabilities;
+    uint16_t htCapabilityInfo;
+    uint32_t vhtCapabilityInfo;
+    uint8_t vendorOuiCount;
+    uint32_t vendorOuis[4];
+};
+
+struct BluetoothDeviceEvent {
+    uint8_t mac[6];
+    uint8_t addressType;
+    char name[64];
+    int8_t rssi;
+    bool hasTxPower;
+    int8_t txPower;
+    uint8_t serviceUuid16Count;
+    uint16_t serviceUuid16[8];
+    uint8_t serviceUuid128Count;
+    uint8_t serviceUuid128[2][16];
+    bool hasManufacturerData;
+    uint16_t manufacturerId;
+    uint8_t manufacturerDataLength;
+    uint8_t manufacturerData[24];
+};
+
+static const size_t FRAME_COUNT = 4096;
+static const size_t ROUNDS = 50;
+static const size_t REPEATS = 15;
+static const size_t BATCH_SIZES[] = { 1, 2, 4, 8, 16, 32, 64 };
+
+// Present in signatures.csv
+static const uint32_t TARGET_OUIS[] = { 0x588e81, 0x3c9180, 0xd8f3bc, 0xec1bbd };
+static const uint16_t TARGET_UUID16 = 0x3100;
+
+static const char* const COMMON_NAMES[] = {
+    "NETGEAR42", "xfinitywifi", "ATT-WIFI-7731", "linksys", "DIRECT-4F-HP OfficeJet",
+    "Starbucks WiFi", "eduroam", "MySpectrumWiFi9c-5G", "TP-Link_2E8A", "Verizon_X7KQ2P",
+    "Galaxy S23 1F2A", "iPhone", "HOME-5521", "CenturyLink0428", "Guest", ""
+};
+static const char* const COMMON_BLE_NAMES[] = {
+    "Tile", "JBL Flip 5", "[TV] Samsung 7 Series", "LE-Bose QC35", "Fitbit Charge 5",
+    "Apple Watch", "", "", "", ""
+};
+
+static bool readImage(const char* path, std::vector<uint32_t>& image, size_t& length) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    length = data.size();
+    image.assign((length + 3) / 4, 0);
+    memcpy(image.data(), data.data(), length);
+    return true;
+}
+
+// A mix of background traffic and a few percent of frames from target OUIs
+// or with target names, repeating like beacons from a fixed set of APs.
+static void makeWiFiFrames(std::mt19937& rng, std::vector<WiFiFrameEvent>& frames) {
+    const size_t sources = 200;
+    std::vector<WiFiFrameEvent> aps(sources);
+    const size_t commonCount = sizeof(COMMON_NAMES) / sizeof(COMMON_NAMES[0]);
+    for (size_t i = 0; i < sources; i++) {
+        WiFiFrameEvent& ap = aps[i];
+        memset(&ap, 0, sizeof(ap));
+        uint32_t oui = rng() & 0xFFFFFF;
+        if (i % 25 == 0) oui = TARGET_OUIS[rng() % 4];
+        ap.mac[0] = oui >> 16;
+        ap.mac[1] = oui >> 8;
+        ap.mac[2] = oui;
+        for (int b = 3; b < 6; b++) ap.mac[b] = rng();
+        const char* name = (i % 40 == 7) ? "Flock-A1B2C3" : COMMON_NAMES[rng() % commonCount];
+        snprintf(ap.ssid, sizeof(ap.ssid), "%s", name);
+        ap.rssi = -40 - (int)(rng() % 50);
+        ap.channel = 1 + rng() % 13;
+        ap.frameSubtype = 0x08;
+    }
+    frames.resize(FRAME_COUNT);
+    for (size_t i = 0; i < FRAME_COUNT; i++) frames[i] = aps[rng() % sources];
+}
+
+static void makeBluetoothDevices(std::mt19937& rng, std::vector<BluetoothDeviceEvent>& devices) {
+    const size_t commonCount = sizeof(COMMON_BLE_NAMES) / sizeof(COMMON_BLE_NAMES[0]);
+    devices.resize(FRAME_COUNT);
+    for (size_t i = 0; i < FRAME_COUNT; i++) {
+        BluetoothDeviceEvent& device = devices[i];
+        memset(&device, 0, sizeof(device));
+        for (int b = 0; b < 6; b++) device.mac[b] = rng();
+        if (i % 30 == 0) {
+            uint32_t oui = TARGET_OUIS[rng() % 4];
+            device.mac[0] = oui >> 16;
+            device.mac[1] = oui >> 8;
+            device.mac[2] = oui;
+        }
+        snprintf(device.name, sizeof(device.name), "%s", COMMON_BLE_NAMES[rng() % commonCount]);
+        device.serviceUuid16Count = rng() % 3;
+        for (uint8_t u = 0; u < device.serviceUuid16Count; u++) device.serviceUuid16[u] = 0xFD00 + rng() % 64;
+        if (i % 50 == 0) device.serviceUuid16[device.serviceUuid16Count++] = TARGET_UUID16;
+    }
+}
+
+// The pre-batching path: every table is visited once per frame.
+static void matchWiFiSingly(const SignatureSet& set, const WiFiFrameEvent* frames, size_t count, BatchMatch* out) {
+    for (size_t i = 0; i < count; i++) {
+        out[i].macIndex = set.macPrefixes.find(frames[i].mac);
+        out[i].nameIndex = BatchMatcher::NO_MATCH;
+        out[i].uuidIndex = BatchMatcher::NO_MATCH;
+        if (frames[i].ssid[0] != '\0') out[i].nameIndex = BatchMatcher::bestName(set, SignatureSet::NETWORK_NAME, frames[i].ssid);
+    }
+}
+
+static void matchBluetoothSingly(const SignatureSet& set, const BluetoothDeviceEvent* devices, size_t count, BatchMatch* out) {
+    for (size_t i = 0; i < count; i++) {
+        const BluetoothDeviceEvent& device = devices[i];
+        out[i].macIndex = set.macPrefixes.find(device.mac);
+        out[i].nameIndex = BatchMatcher::NO_MATCH;
+        if (device.name[0] != '\0') out[i].nameIndex = BatchMatcher::bestName(set, SignatureSet::BLE_NAME, device.name);
+        out[i].uuidIndex = set.services.findAny(device.serviceUuid16, device.serviceUuid16Count,
+                                                device.serviceUuid128, device.serviceUuid128Count);
+    }
+}
+
+static void matchWiFiBatched(const SignatureSet& set, const WiFiFrameEvent* frames, size_t count,
+                             size_t batch, const uint8_t* skip, BatchMatch* out) {
+    for (size_t start = 0; start < count; start += batch) {
+        size_t n = count - start < batch ? count - start : batch;
+        BatchMatcher::reset(out + start, n);
+        BatchMatcher::matchMacPrefixes(set.macPrefixes, frames + start, n, skip, out + start);
+        BatchMatcher::matchNames(set, SignatureSet::NETWORK_NAME, frames + start, n, &WiFiFrameEvent::ssid, skip, out + start);
+    }
+}
+
+static void matchBluetoothBatched(const SignatureSet& set, const BluetoothDeviceEvent* devices, size_t count,
+                                  size_t batch, const uint8_t* skip, BatchMatch* out) {
+    for (size_t start = 0; start < count; start += batch) {
+        size_t n = count - start < batch ? count - start : batch;
+        BatchMatcher::reset(out + start, n);
+        BatchMatcher::matchMacPrefixes(set.macPrefixes, devices + start, n, skip, out + start);
+        BatchMatcher::matchNames(set, SignatureSet::BLE_NAME, devices + start, n, &BluetoothDeviceEvent::name, skip, out + start);
+        BatchMatcher::matchServices(set.services, devices + start, n, skip, out + start);
+    }
+}
+
+static bool sameMatches(const std::vector<BatchMatch>& a, const std::vector<BatchMatch>& b) {
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i].macIndex != b[i].macIndex || a[i].nameIndex != b[i].nameIndex || a[i].uuidIndex != b[i].uuidIndex) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename Match>
+static double timeNsPerFrame(Match match) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (size_t round = 0; round < ROUNDS; round++) match();
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / (ROUNDS * FRAME_COUNT);
+}
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        fprintf(stderr, "usage: batchbench signatures.bin\n");
+        return 2;
+    }
+
+    std::vector<uint32_t> image;
+    size_t length = 0;
+    if (!readImage(argv[1], image, length)) {
+        fprintf(stderr, "%s: cannot read\n", argv[1]);
+        return 1;
+    }
+    SignatureSet set;
+    const char* error = nullptr;
+    if (!SignatureDatabase::parse((const uint8_t*)image.data(), length, set, &error)) {
+        fprintf(stderr, "%s: %s\n", argv[1], error);
+        return 1;
+    }
+
+    std::mt19937 rng(1);
+    std::vector<WiFiFrameEvent> frames;
+    std::vector<BluetoothDeviceEvent> devices;
+    makeWiFiFrames(rng, frames);
+    makeBluetoothDevices(rng, devices);
+    std::vector<uint8_t> skip(FRAME_COUNT, 0);
+    std::vector<BatchMatch> expected(FRAME_COUNT), actual(FRAME_COUNT);
+
+    // Column 0 is per-frame matching, then one column per batch size.
+    const size_t batchCount = sizeof(BATCH_SIZES) / sizeof(BATCH_SIZES[0]);
+    std::vector<BatchMatch> expectedBle(FRAME_COUNT);
+    matchWiFiSingly(set, frames.data(), FRAME_COUNT, expected.data());
+    matchBluetoothSingly(set, devices.data(), FRAME_COUNT, expectedBle.data());
+    for (size_t b = 0; b < batchCount; b++) {
+        matchWiFiBatched(set, frames.data(), FRAME_COUNT, BATCH_SIZES[b], skip.data(), actual.data());
+        if (!sameMatches(expected, actual)) {
+            fprintf(stderr, "wifi batch %zu: results differ from per-frame matching\n", BATCH_SIZES[b]);
+            return 1;
+        }
+        matchBluetoothBatched(set, devices.data(), FRAME_COUNT, BATCH_SIZES[b], skip.data(), actual.data());
+        if (!sameMatches(expectedBle, actual)) {
+            fprintf(stderr, "ble batch %zu: results differ from per-frame matching\n", BATCH_SIZES[b]);
+            return 1;
+        }
+    }
+
+    // Every configuration is timed once per pass and keeps its best pass, so
+    // host noise (frequency changes, other tenants) hits all of them alike
+    // instead of whichever happened to run during it.
+    std::vector<double> bestWifi(batchCount + 1, 0), bestBle(batchCount + 1, 0);
+    for (size_t repeat = 0; repeat < REPEATS; repeat++) {
+        for (size_t c = 0; c <= batchCount; c++) {
+            double wifi, ble;
+            if (c == 0) {
+                wifi = timeNsPerFrame([&]() { matchWiFiSingly(set, frames.data(), FRAME_COUNT, actual.data()); });
+                ble = timeNsPerFrame([&]() { matchBluetoothSingly(set, devices.data(), FRAME_COUNT, actual.data()); });
+            } else {
+                size_t batch = BATCH_SIZES[c - 1];
+                wifi = timeNsPerFrame([&]() {
+                    matchWiFiBatched(set, frames.data(), FRAME_COUNT, batch, skip.data(), actual.data());
+                });
+                ble = timeNsPerFrame([&]() {
+                    matchBluetoothBatched(set, devices.data(), FRAME_COUNT, batch, skip.data(), actual.data());
+                });
+            }
+            if (repeat == 0 || wifi < bestWifi[c]) bestWifi[c] = wifi;
+            if (repeat == 0 || ble < bestBle[c]) bestBle[c] = ble;
+        }
+    }
+
+    printf("%zu frames x %zu rounds, best of %zu passes, revision %u signatures\n\n",
+           FRAME_COUNT, ROUNDS, REPEATS, set.revision);
+    printf("%-10s %12s %12s\n", "batch", "wifi ns/fr", "ble ns/fr");
+    printf("%-10s %12.1f %12.1f\n", "per-frame", bestWifi[0], bestBle[0]);
+    for (size_t b = 0; b < batchCount; b++) {
+        printf("%-10zu %12.1f %12.1f\n", BATCH_SIZES[b], bestWifi[b + 1], bestBle[b + 1]);
+    }
+    return 0;
+}
@@ -0,0 +1,102 @@
+// busbench - host cost of one EventBus publish.
+//
+// Compares the bus as it was, one std::function per event type with a
+// hand-written fan-out lambda, against EventTopic with the same sinks
+// subscribed separately, for 0 to 4 sinks. Each sink is an out-of-line
+// function that touches the event, like the firmware's handlers, so the
+// numbers are dispatch plus a call, not an empty loop the optimizer can
+// delete. Host call and branch costs differ from the ESP32's, so treat the
+// numbers as relative, not absolute.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <chrono>
+#include <functional>
+
+#include "EventTopic.h"
+
+// Same size and layout class as the firmware's ThreatEvent.
+struct ThreatEvent {
+    uint8_t mac[6];
+    char identifier[64];
+    int8_t rssi;
+    int8_t rssiSmoothed;
+    uint8_t trend;
+    uint8_t distance;
+    uint8_t channel;
+    const char* radioType;
+    uint8_t certainty;
+    const char* category;
+};
+
+static const size_t PUBLISHES = 20000000;
+static const uint8_t MAX_SINKS = 4;
+
+static volatile uint32_t sink;
+
+__attribute__((noinline)) static void sinkA(const ThreatEvent& event) { sink += event.rssi; }
+__attribute__((noinline)) static void sinkB(const ThreatEvent& event) { sink += event.certainty; }
+__attribute__((noinline)) static void sinkC(const ThreatEvent& event) { sink += event.channel; }
+__attribute__((noinline)) static void sinkD(const ThreatEvent& event) { sink += event.mac[5]; }
+
+typedef void (*Sink)(const ThreatEvent&);
+static const Sink SINKS[MAX_SINKS] = { sinkA, sinkB, sinkC, sinkD };
+
+// The old EventBus: one handler slot, fan-out written into the lambda.
+static std::function<void(const ThreatEvent&)> makeFanOut(uint8_t sinks) {
+    switch (sinks) {
+        case 0: return nullptr;
+        case 1: return [](const ThreatEvent& e) { sinkA(e); };
+        case 2: return [](const ThreatEvent& e) { sinkA(e); sinkB(e); };
+        case 3: return [](const ThreatEvent& e) { sinkA(e); sinkB(e); sinkC(e); };
+        default: return [](const ThreatEvent& e) { sinkA(e); sinkB(e); sinkC(e); sinkD(e); };
+    }
+}
+
+// Keeps the handler and topic opaque to the optimizer, as they are in the
+// firmware where setup() fills them in another translation unit.
+template <typename T>
+__attribute__((noinline)) static T& launder(T& value) {
+    asm volatile("" : : "r"(&value) : "memory");
+    return value;
+}
+
+template <typename Publish>
+static double timeNsPerPublish(Publish publish) {
+    ThreatEvent event;
+    memset(&event, 0, sizeof(event));
+    event.rssi = -60;
+    for (size_t i = 0; i < PUBLISHES / 10; i++) publish(event);  // Warm up
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < PUBLISHES; i++) {
+        event.channel = (uint8_t)i;
+        publish(event);
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / PUBLISHES;
+}
+
+int main() {
+    printf("%zu publishes of a %zu-byte event\n\n", PUBLISHES, sizeof(ThreatEvent));
+    printf("%-6s %16s %16s\n", "sinks", "std::function ns", "EventTopic ns");
+
+    for (uint8_t sinks = 0; sinks <= MAX_SINKS; sinks++) {
+        std::function<void(const ThreatEvent&)> handler = makeFanOut(sinks);
+        std::function<void(const ThreatEvent&)>& oldBus = launder(handler);
+        double before = timeNsPerPublish([&](const ThreatEvent& e) {
+            if (oldBus) oldBus(e);
+        });
+
+        EventTopic<MAX_SINKS, const ThreatEvent&> topic;
+        for (uint8_t i = 0; i < sinks; i++) topic.subscribe(SINKS[i]);
+        EventTopic<MAX_SINKS, const ThreatEvent&>& newBus = launder(topic);
+        double after = timeNsPerPublish([&](const ThreatEvent& e) {
+            newBus.publish(e);
+        });
+
+        printf("%-6u %16.2f %16.2f\n", sinks, before, after);
+    }
+    return 0;
+}
@@ -0,0 +1,736 @@
+// sigcompile - builds the on-device signature database from a CSV list.
+//
+// Compiled against the firmware's own src/ modules (see Makefile), so the
+// OUI table, name automaton and UUID set it writes are byte-for-byte what
+// the ESP32 would build, and every output is re-read with the same
+// SignatureDatabase::parse() the firmware uses before it is accepted.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "OuiTable.h"
+#include "NameMatcher.h"
+#include "UuidSet.h"
+#include "SignatureDatabase.h"
+
+static const char* const CATEGORY_IDENTIFIERS[] = {
+    "SURVEILLANCE_DEVICE",
+    "ACOUSTIC_DETECTOR"
+};
+static_assert(sizeof(CATEGORY_IDENTIFIERS) / sizeof(CATEGORY_IDENTIFIERS[0]) == SignatureSet::CATEGORY_COUNT,
+              "CATEGORY_IDENTIFIERS must list every SignatureSet::Category");
+
+static const size_t MAX_SSID_LENGTH = 32;
+static const size_t MAX_BLE_NAME_LENGTH = 63;
+static const size_t UUID_TEXT_LENGTH = 36;
+static const size_t MAX_FILE_BYTES = 256 * 1024;  // ThreatAnalyzer::MAX_SIGNATURE_FILE_BYTES
+
+struct Signature {
+    std::string value;      // As written, used for names and the header
+    uint32_t oui;
+    Uuid128 uuid;
+    SignatureInfo info;
+    std::string note;
+    int line;
+};
+
+struct SignatureList {
+    std::vector<Signature> kinds[SignatureSet::KIND_COUNT];
+    int errors = 0;
+};
+
+static const char* kindName(int kind) {
+    static const char* const names[] = {"oui", "ssid", "ble", "uuid"};
+    return names[kind];
+}
+
+static void report(SignatureList& list, const char* path, int line, const std::string& message) {
+    fprintf(stderr, "%s:%d: %s\n", path, line, message.c_str());
+    list.errors++;
+}
+
+// Splits one CSV record. Fields may be double-quoted, with "" for a quote.
+static std::vector<std::string> splitCsv(const std::string& line) {
+    std::vector<std::string> fields;
+    std::string field;
+    bool quoted = false;
+
+    for (size_t i = 0; i < line.size(); i++) {
+        char c = line[i];
+        if (quoted) {
+            if (c == '"' && i + 1 < line.size() && line[i + 1] == '"') {
+                field += '"';
+                i++;
+            } else if (c == '"') {
+                quoted = false;
+            } else {
+                field += c;
+            }
+        } else if (c == '"') {
+            quoted = true;
+        } else if (c == ',') {
+            fields.push_back(field);
+            field.clear();
+        } else {
+            field += c;
+        }
+    }
+    fields.push_back(field);
+
+    for (size_t i = 0; i < fields.size(); i++) {
+        std::string& f = fields[i];
+        size_t start = f.find_first_not_of(" \t\r");
+        size_t end = f.find_last_not_of(" \t\r");
+        f = (start == std::string::npos) ? std::string() : f.substr(start, end - start + 1);
+    }
+    return fields;
+}
+
+static int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// Accepts 58:8e:81, 58-8E-81 or 588e81.
+static bool parseOui(const std::string& text, uint32_t& out) {
+    std::string digits;
+    for (size_t i = 0; i < text.size(); i++) {
+        char c = text[i];
+        if ((c == ':' || c == '-') && i % 3 == 2 && text.size() == 8) continue;
+        if (hexValue(c) < 0) return false;
+        digits += c;
+    }
+    if (digits.size() != 6) return false;
+    out = (uint32_t)strtoul(digits.c_str(), nullptr, 16);
+    return true;
+}
+
+// Accepts the canonical 36-character form or a 4-digit Bluetooth SIG short form.
+static bool parseUuid(const std::string& text, Uuid128& out) {
+    if (text.size() == 4) {
+        for (size_t i = 0; i < 4; i++) {
+            if (hexValue(text[i]) < 0) return false;
+        }
+        out = Uuid128::fromShort((uint16_t)strtoul(text.c_str(), nullptr, 16));
+        return true;
+    }
+    if (text.size() != UUID_TEXT_LENGTH) return false;
+    for (size_t i = 0; i < text.size(); i++) {
+        bool dash = (i == 8 || i == 13 || i == 18 || i == 23);
+        if (dash ? text[i] != '-' : hexValue(text[i]) < 0) return false;
+    }
+    out = Uuid128::parse(text.c_str());
+    return true;
+}
+
+static void formatUuid(const Uuid128& uuid, char* out) {
+    static const uint8_t order[16] = {15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0};
+    char* p = out;
+    for (size_t i = 0; i < 16; i++) {
+        if (i == 4 || i == 6 || i == 8 || i == 10) *p++ = '-';
+        p += sprintf(p, "%02x", uuid.bytes[order[i]]);
+    }
+}
+
+static bool parseName(const std::string& text, size_t maxLength, std::string& problem) {
+    if (text.empty()) {
+        problem = "empty name pattern would match everything";
+        return false;
+    }
+    if (text.size() > maxLength) {
+        problem = "name pattern longer than " + std::to_string(maxLength) + " characters can never match";
+        return false;
+    }
+    for (size_t i = 0; i < text.size(); i++) {
+        if ((uint8_t)text[i] < 0x20 || (uint8_t)text[i] > 0x7E) {
+            problem = "name patterns must be printable ASCII";
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool sameSignature(int kind, const Signature& a, const Signature& b) {
+    switch (kind) {
+        case SignatureSet::MAC_PREFIX:   return a.oui == b.oui;
+        case SignatureSet::SERVICE_UUID: return memcmp(a.uuid.bytes, b.uuid.bytes, 16) == 0;
+        default:                         return strcasecmp(a.value.c_str(), b.value.c_str()) == 0;
+    }
+}
+
+// Info is only written out when some entry differs from the kind's
+// defaults; a missing info section or header array means "all defaults".
+static bool usesDefaultInfo(const std::vector<Signature>& signatures, int kind) {
+    SignatureInfo defaults = SignatureSet::defaultInfo((SignatureSet::Kind)kind);
+    for (size_t i = 0; i < signatures.size(); i++) {
+        if (signatures[i].info.weight != defaults.weight || signatures[i].info.category != defaults.category) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool readCsv(const char* path, SignatureList& list) {
+    std::ifstream in(path);
+    if (!in) {
+        fprintf(stderr, "%s: cannot open\n", path);
+        return false;
+    }
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line)) {
+        lineNumber++;
+        std::vector<std::string> fields = splitCsv(line);
+        if (fields.size() == 1 && fields[0].empty()) continue;
+        if (!fields[0].empty() && fields[0][0] == '#') continue;
+        if (fields.size() < 2 || fields.size() > 5) {
+            report(list, path, lineNumber, "expected kind,value[,weight[,category[,note]]]");
+            continue;
+        }
+
+        int kind = -1;
+        for (int k = 0; k < SignatureSet::KIND_COUNT; k++) {
+            if (fields[0] == kindName(k)) kind = k;
+        }
+        if (kind < 0) {
+            report(list, path, lineNumber, "unknown kind '" + fields[0] + "' (use oui, ssid, ble or uuid)");
+            continue;
+        }
+
+        Signature sig;
+        sig.value = fields[1];
+        sig.oui = 0;
+        memset(&sig.uuid, 0, sizeof(sig.uuid));
+        sig.info = SignatureSet::defaultInfo((SignatureSet::Kind)kind);
+        sig.note = fields.size() > 4 ? fields[4] : std::string();
+        sig.line = lineNumber;
+
+        std::string problem;
+        if (kind == SignatureSet::MAC_PREFIX && !parseOui(sig.value, sig.oui)) {
+            problem = "bad OUI '" + sig.value + "' (expected aa:bb:cc)";
+        } else if (kind == SignatureSet::SERVICE_UUID && !parseUuid(sig.value, sig.uuid)) {
+            problem = "bad UUID '" + sig.value + "' (expected 0000180a-0000-1000-8000-00805f9b34fb or 180a)";
+        } else if (kind == SignatureSet::NETWORK_NAME) {
+            parseName(sig.value, MAX_SSID_LENGTH, problem);
+        } else if (kind == SignatureSet::BLE_NAME) {
+            parseName(sig.value, MAX_BLE_NAME_LENGTH, problem);
+        }
+
+        if (problem.empty() && fields.size() > 2 && !fields[2].empty()) {
+            char* end = nullptr;
+            long weight = strtol(fields[2].c_str(), &end, 10);
+            if (*end != '\0' || weight < 0 || weight > 100) problem = "weight must be 0-100";
+            else sig.info.weight = (uint8_t)weight;
+        }
+        if (problem.empty() && fields.size() > 3 && !fields[3].empty()) {
+            int category = -1;
+            for (int c = 0; c < SignatureSet::CATEGORY_COUNT; c++) {
+                if (fields[3] == SignatureSet::categoryName((uint8_t)c)) category = c;
+            }
+            if (category < 0) problem = "unknown category '" + fields[3] + "'";
+            else sig.info.category = (uint8_t)category;
+        }
+        if (problem.empty()) {
+            std::vector<Signature>& existing = list.kinds[kind];
+            for (size_t i = 0; i < existing.size(); i++) {
+                if (sameSignature(kind, existing[i], sig)) {
+                    problem = "duplicate of line " + std::to_string(existing[i].line);
+                    break;
+                }
+            }
+        }
+
+        if (!problem.empty()) {
+            report(list, path, lineNumber, problem);
+            continue;
+        }
+        list.kinds[kind].push_back(sig);
+    }
+
+    std::vector<Signature>& ouis = list.kinds[SignatureSet::MAC_PREFIX];
+    std::sort(ouis.begin(), ouis.end(), [](const Signature& a, const Signature& b) { return a.oui < b.oui; });
+    return list.errors == 0;
+}
+
+// Index built from a SignatureList, plus the file image holding it.
+struct CompiledIndex {
+    std::vector<uint32_t> ouis;
+    std::vector<const char*> networkPatterns;
+    std::vector<const char*> blePatterns;
+    std::vector<Uuid128> uuids;
+    std::vector<uint16_t> networkBuffer;
+    std::vector<uint16_t> bleBuffer;
+    std::vector<uint16_t> uuidBuffer;
+    NameAutomaton networkNames;
+    NameAutomaton bleNames;
+    UuidSetTable services;
+    std::vector<SignatureInfo> info[SignatureSet::KIND_COUNT];
+    std::vector<uint8_t> image;
+    size_t sectionBytes[SignatureDatabase::SECTION_SERVICE_UUID_INFO + 1];
+};
+
+static bool buildNames(const std::vector<const char*>& patterns, std::vector<uint16_t>& buffer, NameAutomaton& out) {
+    memset(&out, 0, sizeof(out));
+    if (patterns.empty()) return true;
+    size_t bytes = NameMatcher::requiredBytes(patterns.data(), patterns.size());
+    buffer.assign(bytes / sizeof(uint16_t) + 1, 0);
+    return bytes != 0 && NameMatcher::build(patterns.data(), patterns.size(), buffer.data(), bytes, out);
+}
+
+static void append(std::vector<uint8_t>& out, const void* data, size_t length) {
+    const uint8_t* bytes = (const uint8_t*)data;
+    out.insert(out.end(), bytes, bytes + length);
+}
+
+static std::vector<uint8_t> serializeNames(const NameAutomaton& a) {
+    std::vector<uint8_t> out;
+    uint16_t header[4] = {a.stateCount, a.classCount, a.patternCount, 0};
+    append(out, header, sizeof(header));
+    append(out, a.charClass, 256);
+    append(out, a.transitions, sizeof(uint16_t) * a.stateCount * a.classCount);
+    append(out, a.firstPattern, sizeof(uint16_t) * a.stateCount);
+    append(out, a.outputLink, sizeof(uint16_t) * a.stateCount);
+    append(out, a.nextPattern, sizeof(uint16_t) * a.patternCount);
+    return out;
+}
+
+static std::vector<uint8_t> serializeUuids(const UuidSetTable& t) {
+    std::vector<uint8_t> out;
+    uint16_t header[4] = {t.entryCount, t.slotMask, 0, 0};
+    append(out, header, sizeof(header));
+    append(out, t.entries, sizeof(Uuid128) * t.entryCount);
+    append(out, t.aliasSlots, sizeof(uint16_t) * ((size_t)t.slotMask + 1));
+    append(out, t.fullSlots, sizeof(uint16_t) * ((size_t)t.slotMask + 1));
+    return out;
+}
+
+static bool compile(const SignatureList& list, uint32_t revision, CompiledIndex& index) {
+    for (int k = 0; k < SignatureSet::KIND_COUNT; k++) {
+        for (size_t i = 0; i < list.kinds[k].size(); i++) {
+            const Signature& sig = list.kinds[k][i];
+            index.info[k].push_back(sig.info);
+            if (k == SignatureSet::MAC_PREFIX) index.ouis.push_back(sig.oui);
+            if (k == SignatureSet::NETWORK_NAME) index.networkPatterns.push_back(sig.value.c_str());
+            if (k == SignatureSet::BLE_NAME) index.blePatterns.push_back(sig.value.c_str());
+            if (k == SignatureSet::SERVICE_UUID) index.uuids.push_back(sig.uuid);
+        }
+    }
+
+    if (!buildNames(index.networkPatterns, index.networkBuffer, index.networkNames) ||
+        !buildNames(index.blePatterns, index.bleBuffer, index.bleNames)) {
+        fprintf(stderr, "name automaton exceeds the 16-bit state or pattern limit\n");
+        return false;
+    }
+    memset(&index.services, 0, sizeof(index.services));
+    if (!index.uuids.empty()) {
+        size_t bytes = UuidSet::requiredBytes(index.uuids.size());
+        index.uuidBuffer.assign(bytes / sizeof(uint16_t) + 1, 0);
+        if (bytes == 0 || !UuidSet::build(index.uuids.data(), index.uuids.size(),
+                                          index.uuidBuffer.data(), bytes, index.services)) {
+            fprintf(stderr, "too many service UUIDs\n");
+            return false;
+        }
+    }
+
+    std::vector<std::pair<uint16_t, std::vector<uint8_t> > > sections;
+    if (!index.ouis.empty()) {
+        std::vector<uint8_t> data;
+        append(data, index.ouis.data(), sizeof(uint32_t) * index.ouis.size());
+        sections.push_back(std::make_pair((uint16_t)SignatureDatabase::SECTION_OUI, data));
+    }
+    if (!index.networkPatterns.empty()) {
+        sections.push_back(std::make_pair((uint16_t)SignatureDatabase::SECTION_NETWORK_NAMES, serializeNames(index.networkNames)));
+    }
+    if (!index.blePatterns.empty()) {
+        sections.push_back(std::make_pair((uint16_t)SignatureDatabase::SECTION_BLE_NAMES, serializeNames(index.bleNames)));
+    }
+    if (!index.uuids.empty()) {
+        sections.push_back(std::make_pair((uint16_t)SignatureDatabase::SECTION_SERVICE_UUIDS, serializeUuids(index.services)));
+    }
+    for (int k = 0; k < SignatureSet::KIND_COUNT; k++) {
+        if (usesDefaultInfo(list.kinds[k], k)) continue;
+        std::vector<uint8_t> data;
+        append(data, index.info[k].data(), sizeof(SignatureInfo) * index.info[k].size());
+        sections.push_back(std::make_pair((uint16_t)(SignatureDatabase::SECTION_OUI_INFO + k), data));
+    }
+
+    memset(index.sectionBytes, 0, sizeof(index.sectionBytes));
+    std::vector<uint8_t>& image = index.image;
+    size_t tableEnd = sizeof(SignatureFileHeader) + sections.size() * sizeof(SignatureSectionEntry);
+    image.assign((tableEnd + 3) & ~(size_t)3, 0);
+
+    for (size_t i = 0; i < sections.size(); i++) {
+        SignatureSectionEntry entry;
+        entry.type = sections[i].first;
+        entry.reserved = 0;
+        entry.offset = (uint32_t)image.size();
+        entry.length = (uint32_t)sections[i].second.size();
+        memcpy(&image[sizeof(SignatureFileHeader) + i * sizeof(entry)], &entry, sizeof(entry));
+        append(image, sections[i].second.data(), sections[i].second.size());
+        while (image.size() % 4) image.push_back(0);
+        index.sectionBytes[entry.type] = entry.length;
+    }
+
+    SignatureFileHeader header;
+    header.magic = SignatureDatabase::MAGIC;
+    header.formatVersion = SignatureDatabase::FORMAT_VERSION;
+    header.sectionCount = (uint16_t)sections.size();
+    header.revision = revision;
+    header.totalLength = (uint32_t)image.size();
+    header.crc32 = SignatureDatabase::crc32(image.data() + sizeof(header), image.size() - sizeof(header));
+    header.reserved = 0;
+    memcpy(image.data(), &header, sizeof(header));
+    return true;
+}
+
+// Loads the image back through the firmware parser and checks that every
+// input signature is found again with its own metadata.
+static bool verify(const SignatureList& list, const CompiledIndex& index) {
+    std::vector<uint32_t> aligned((index.image.size() + 3) / 4);
+    memcpy(aligned.data(), index.image.data(), index.image.size());
+
+    SignatureSet set;
+    const char* problem = nullptr;
+    if (!SignatureDatabase::parse((const uint8_t*)aligned.data(), index.image.size(), set, &problem)) {
+        fprintf(stderr, "self-check: firmware parser rejected the output: %s\n", problem);
+        return false;
+    }
+
+    int failures = 0;
+    for (int k = 0; k < SignatureSet::KIND_COUNT; k++) {
+        for (size_t i = 0; i < list.kinds[k].size(); i++) {
+            const Signature& sig = list.kinds[k][i];
+            bool found = false;
+            if (k == SignatureSet::MAC_PREFIX) {
+                found = set.macPrefixes.find(sig.oui) == (int)i;
+            } else if (k == SignatureSet::SERVICE_UUID) {
+                found = set.services.find(sig.uuid.bytes) == (int)i;
+            } else {
+                const NameMatcher& names = (k == SignatureSet::NETWORK_NAME) ? set.networkNames : set.bleNames;
+                uint16_t hits[64];
+                size_t count = names.scan(sig.value.c_str(), hits, 64);
+                found = std::find(hits, hits + count, (uint16_t)i) != hits + count;
+            }
+            SignatureInfo info = set.getInfo((SignatureSet::Kind)k, (int)i);
+            if (!found || info.weight != sig.info.weight || info.category != sig.info.category) {
+                fprintf(stderr, "self-check: %s '%s' (line %d) does not round-trip\n",
+                        kindName(k), sig.value.c_str(), sig.line);
+                failures++;
+            }
+        }
+    }
+    return failures == 0;
+}
+
+// Most patterns one input position can report: the state's own patterns
+// plus everything on its output-link chain.
+static size_t maxOutputsPerByte(const NameAutomaton& a) {
+    size_t worst = 0;
+    for (uint16_t s = 0; s < a.stateCount; s++) {
+        size_t outputs = 0;
+        uint16_t state = (a.firstPattern[s] != NameAutomaton::NO_PATTERN) ? s : a.outputLink[s];
+        for (; state != 0; state = a.outputLink[state]) {
+            for (uint16_t id = a.firstPattern[state]; id != NameAutomaton::NO_PATTERN; id = a.nextPattern[id]) {
+                outputs++;
+            }
+        }
+        worst = std::max(worst, outputs);
+    }
+    return worst;
+}
+
+// Probes for a miss that lands at the start of the longest occupied run.
+static size_t worstProbeLength(const uint16_t* slots, size_t slotCount) {
+    size_t worst = 0;
+    for (size_t start = 0; start < slotCount; start++) {
+        size_t run = 0;
+        while (run < slotCount && slots[(start + run) % slotCount] != 0) run++;
+        worst = std::max(worst, run + 1);
+    }
+    return worst;
+}
+
+static void printReport(const char* input, const CompiledIndex& index, uint32_t revision, const char* output) {
+    size_t ouiCount = index.ouis.size();
+    size_t ouiProbes = 0;
+    while (((size_t)1 << ouiProbes) < ouiCount) ouiProbes++;
+
+    printf("%s: %zu OUIs, %zu SSID patterns, %zu BLE name patterns, %zu service UUIDs\n", input,
+           ouiCount, index.networkPatterns.size(), index.blePatterns.size(), index.uuids.size());
+    printf("  OUI table       %6zu bytes  binary search, %zu probes worst case\n",
+           index.sectionBytes[SignatureDatabase::SECTION_OUI], ouiProbes + (ouiCount ? 1 : 0));
+
+    const NameAutomaton* automata[2] = {&index.networkNames, &index.bleNames};
+    const char* labels[2] = {"SSID names", "BLE names"};
+    const uint16_t types[2] = {SignatureDatabase::SECTION_NETWORK_NAMES, SignatureDatabase::SECTION_BLE_NAMES};
+    for (int i = 0; i < 2; i++) {
+        const NameAutomaton& a = *automata[i];
+        if (a.stateCount == 0) {
+            printf("  %-15s      0 bytes\n", labels[i]);
+            continue;
+        }
+        printf("  %-15s %6zu bytes  %u states x %u classes, 1 lookup per byte, at most %zu patterns end at one byte\n",
+               labels[i], index.sectionBytes[types[i]], a.stateCount, a.classCount, maxOutputsPerByte(a));
+    }
+
+    if (index.uuids.empty()) {
+        printf("  service UUIDs        0 bytes\n");
+    } else {
+        size_t slots = (size_t)index.services.slotMask + 1;
+        printf("  service UUIDs   %6zu bytes  %zu slots, %zu probes worst case (16-bit), %zu (128-bit)\n",
+               index.sectionBytes[SignatureDatabase::SECTION_SERVICE_UUIDS], slots,
+               worstProbeLength(index.services.aliasSlots, slots),
+               worstProbeLength(index.services.fullSlots, slots));
+    }
+
+    size_t infoBytes = 0;
+    for (int k = 0; k < SignatureSet::KIND_COUNT; k++) {
+        infoBytes += index.sectionBytes[SignatureDatabase::SECTION_OUI_INFO + k];
+    }
+    printf("  signature info  %6zu bytes\n", infoBytes);
+    printf("  total           %6zu bytes  revision %u", index.image.size(), revision);
+    if (index.image.size() > MAX_FILE_BYTES) printf("  (over the %zu byte firmware limit)", MAX_FILE_BYTES);
+    printf("%s%s\n", output ? " -> " : "", output ? output : "");
+}
+
+static std::string escapeString(const std::string& text) {
+    std::string out;
+    for (size_t i = 0; i < text.size(); i++) {
+        if (text[i] == '"' || text[i] == '\\') out += '\\';
+        out += text[i];
+    }
+    return out;
+}
+
+static std::string infoLiteral(const SignatureInfo& info) {
+    return "{" + std::to_string(info.weight) + ", SignatureSet::" + CATEGORY_IDENTIFIERS[info.category] + "}";
+}
+
+// Writes `lines` as the body of a brace-enclosed array, with a comma after
+// every entry but the last and optional trailing comments lined up.
+static void emitArrayBody(std::ostringstream& out, const std::vector<std::string>& items,
+                          const std::vector<std::string>& notes) {
+    size_t width = 0;
+    for (size_t i = 0; i < items.size(); i++) width = std::max(width, items[i].size() + 1);
+    for (size_t i = 0; i < items.size(); i++) {
+        std::string item = items[i] + (i + 1 < items.size() ? "," : "");
+        out << "        " << item;
+        if (!notes[i].empty()) out << std::string(width - item.size() + 2, ' ') << "// " << notes[i];
+        out << "\n";
+    }
+}
+
+static void emitInfo(std::ostringstream& out, const char* name, const std::vector<std::string>& items) {
+    if (items.empty()) {
+        out << "    const SignatureInfo* const " << name << " = nullptr;  // Defaults for every entry\n";
+        return;
+    }
+    out << "    const SignatureInfo " << name << "[] = {\n";
+    emitArrayBody(out, items, std::vector<std::string>(items.size()));
+    out << "    };\n";
+}
+
+static std::string generateHeader(const SignatureList& list) {
+    std::ostringstream out;
+    const std::vector<Signature>& ouis = list.kinds[SignatureSet::MAC_PREFIX];
+    const std::vector<Signature>& ssids = list.kinds[SignatureSet::NETWORK_NAME];
+    const std::vector<Signature>& bles = list.kinds[SignatureSet::BLE_NAME];
+    const std::vector<Signature>& uuids = list.kinds[SignatureSet::SERVICE_UUID];
+
+    out << "#ifndef DEVICE_SIGNATURES_H\n"
+           "#define DEVICE_SIGNATURES_H\n"
+           "\n"
+           "#include <Arduino.h>\n"
+           "#include \"OuiTable.h\"\n"
+           "#include \"UuidSet.h\"\n"
+           "#include \"SignatureDatabase.h\"\n"
+           "\n"
+           "// Generated by tools/sigcompile from tools/sigcompile/signatures.csv.\n"
+           "// Edit the CSV and run `make headers` there instead of editing this file.\n"
+           "\n"
+           "namespace DeviceProfiles {\n";
+
+    std::vector<std::string> items, notes, infoItems;
+    auto flush = [&](const char* comment, const char* type, const char* name, const char* countName,
+                     const char* infoName, const char* placeholder) {
+        out << "\n    // " << comment << "\n";
+        out << "    " << type << " " << name << "[] = {\n";
+        if (items.empty()) {
+            out << "        " << placeholder << "\n";
+        } else {
+            emitArrayBody(out, items, notes);
+        }
+        out << "    };\n";
+        out << "    const size_t " << countName << " = " << items.size() << ";\n";
+        emitInfo(out, infoName, infoItems);
+        items.clear();
+        notes.clear();
+        infoItems.clear();
+    };
+
+    for (size_t i = 0; i < ssids.size(); i++) {
+        items.push_back("\"" + escapeString(ssids[i].value) + "\"");
+        notes.push_back(ssids[i].note);
+        if (!usesDefaultInfo(ssids, SignatureSet::NETWORK_NAME)) infoItems.push_back(infoLiteral(ssids[i].info));
+    }
+    flush("Network name patterns for target identification (case-insensitive substrings)",
+          "const char* const", "NetworkNames", "NetworkNameCount", "NetworkNameInfo", "nullptr");
+
+    for (size_t i = 0; i < ouis.size(); i++) {
+        char hex[16];
+        snprintf(hex, sizeof(hex), "0x%06x", ouis[i].oui);
+        items.push_back(hex);
+        notes.push_back(ouis[i].note);
+        if (!usesDefaultInfo(ouis, SignatureSet::MAC_PREFIX)) infoItems.push_back(infoLiteral(ouis[i].info));
+    }
+    out << "\n    // MAC address OUI prefixes for target devices, as 0xAABBCC for aa:bb:cc.\n"
+           "    // Must stay sorted ascending; the static_assert below rejects the build otherwise.\n";
+    {
+        out << "    constexpr uint32_t MACPrefixes[] = {\n";
+        bool anyNote = std::find_if(notes.begin(), notes.end(),
+                                    [](const std::string& n) { return !n.empty(); }) != notes.end();
+        if (items.empty()) {
+            out << "        0\n";
+        } else if (anyNote) {
+            emitArrayBody(out, items, notes);
+        } else {
+            for (size_t i = 0; i < items.size(); i++) {
+                out << (i % 5 == 0 ? "        " : " ") << items[i];
+                if (i + 1 < items.size()) out << ",";
+                if (i % 5 == 4 || i + 1 == items.size()) out << "\n";
+            }
+        }
+        out << "    };\n"
+            << "    const size_t MACPrefixCount = " << items.size() << ";\n"
+            << "    static_assert(OuiTable::isSorted(MACPrefixes, MACPrefixCount),\n"
+               "                  \"DeviceProfiles::MACPrefixes must be sorted ascending without duplicates\");\n"
+               "    constexpr OuiTable MACPrefixTable(MACPrefixes, MACPrefixCount);\n";
+        emitInfo(out, "MACPrefixInfo", infoItems);
+        items.clear();
+        notes.clear();
+        infoItems.clear();
+    }
+
+    for (size_t i = 0; i < bles.size(); i++) {
+        items.push_back("\"" + escapeString(bles[i].value) + "\"");
+        notes.push_back(bles[i].note);
+        if (!usesDefaultInfo(bles, SignatureSet::BLE_NAME)) infoItems.push_back(infoLiteral(bles[i].info));
+    }
+    flush("Bluetooth device name patterns (case-insensitive substrings)",
+          "const char* const", "BLEIdentifiers", "BLEIdentifierCount", "BLEIdentifierInfo", "nullptr");
+
+    for (size_t i = 0; i < uuids.size(); i++) {
+        char text[UUID_TEXT_LENGTH + 1];
+        formatUuid(uuids[i].uuid, text);
+        items.push_back(std::string("Uuid128::parse(\"") + text + "\")");
+        notes.push_back(uuids[i].note);
+        if (!usesDefaultInfo(uuids, SignatureSet::SERVICE_UUID)) infoItems.push_back(infoLiteral(uuids[i].info));
+    }
+    flush("Raven acoustic detection device service UUIDs, converted to binary at\n"
+          "    // compile time. ThreatAnalyzer matches base UUIDs by their 16-bit alias.",
+          "constexpr Uuid128", "RavenServices", "RavenServiceCount", "RavenServiceInfo", "Uuid128::fromShort(0)");
+
+    out << "}\n\n#endif\n";
+    return out.str();
+}
+
+static bool writeFile(const char* path, const std::string& data) {
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        fprintf(stderr, "%s: cannot write\n", path);
+        return false;
+    }
+    bool ok = fwrite(data.data(), 1, data.size(), file) == data.size();
+    ok = (fclose(file) == 0) && ok;
+    if (!ok) fprintf(stderr, "%s: write failed\n", path);
+    return ok;
+}
+
+static bool readFile(const char* path, std::string& data) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    std::ostringstream buffer;
+    buffer << in.rdbuf();
+    data = buffer.str();
+    return true;
+}
+
+static void usage() {
+    fprintf(stderr,
+            "usage: sigcompile [options] signatures.csv\n"
+            "  -o FILE            write the binary database (e.g. signatures.bin)\n"
+            "  -r N               revision number stored in the database (default 1)\n"
+            "  --header FILE      write a matching DeviceSignatures.h (repeatable)\n"
+            "  --check-header FILE\n"
+            "                     fail if FILE differs from the generated header (repeatable)\n");
+}
+
+int main(int argc, char** argv) {
+    const char* input = nullptr;
+    const char* output = nullptr;
+    uint32_t revision = 1;
+    std::vector<const char*> headers;
+    std::vector<const char*> checks;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "-o" && hasValue) {
+            output = argv[++i];
+        } else if (arg == "-r" && hasValue) {
+            revision = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--header" && hasValue) {
+            headers.push_back(argv[++i]);
+        } else if (arg == "--check-header" && hasValue) {
+            checks.push_back(argv[++i]);
+        } else if (arg[0] != '-' && !input) {
+            input = argv[i];
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (!input) {
+        usage();
+        return 2;
+    }
+
+    SignatureList list;
+    if (!readCsv(input, list)) {
+        if (list.errors) fprintf(stderr, "%d error(s), nothing written\n", list.errors);
+        return 1;
+    }
+
+    CompiledIndex index;
+    if (!compile(list, revision, index) || !verify(list, index)) return 1;
+    printReport(input, index, revision, output);
+
+    if (output && !writeFile(output, std::string(index.image.begin(), index.image.end()))) return 1;
+
+    std::string header = generateHeader(list);
+    for (size_t i = 0; i < headers.size(); i++) {
+        if (!writeFile(headers[i], header)) return 1;
+    }
+
+    int stale = 0;
+    for (size_t i = 0; i < checks.size(); i++) {
+        std::string existing;
+        if (!readFile(checks[i], existing) || existing != header) {
+            fprintf(stderr, "%s: out of date with %s\n", checks[i], input);
+            stale++;
+        }
+    }
+    return stale ? 1 : 0;
+}
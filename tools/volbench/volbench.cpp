@@ -0,0 +1,104 @@
+// volbench - host throughput of the I2S volume stage.
+//
+// Compares SoundEngine's old per-sample float loop with VolumeKernel's Q15
+// scale, over 1 KB chunks like the audio task's, at several volumes, and
+// checks the two never differ by more than one LSB. Also times a ramp
+// across a whole chunk, the worst case for a volume change. Host FPUs
+// convert and multiply far faster than the ESP32's, so treat the numbers as
+// relative, not absolute.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include "VolumeKernel.h"
+
+static const size_t CHUNK_SAMPLES = 512;    // SoundEngine::CHUNK_BYTES / 2
+static const size_t CHUNKS = 64;
+static const size_t ROUNDS = 2000;
+static const float LEVELS[] = { 0.1f, 0.4f, 0.6f, 0.9f };
+static const int32_t RAMP_STEP_Q15 = 64;
+
+// SoundEngine::applyVolumeControl before the Q15 kernel.
+static void scaleFloat(int16_t* samples, size_t sampleCount, float volumeLevel) {
+    for (size_t i = 0; i < sampleCount; i++) {
+        int32_t scaled = (int32_t)((int32_t)samples[i] * volumeLevel);
+        if (scaled > 32767) scaled = 32767;
+        if (scaled < -32768) scaled = -32768;
+        samples[i] = (int16_t)scaled;
+    }
+}
+
+// Each round rescales a fresh copy of the source, as the audio task does
+// with every chunk it reads.
+template <typename Scale>
+static double timeNsPerSample(const std::vector<int16_t>& source, std::vector<int16_t>& work, Scale scale) {
+    const size_t total = CHUNK_SAMPLES * CHUNKS;
+    std::chrono::duration<double, std::nano> elapsed(0);
+    for (size_t round = 0; round <= ROUNDS; round++) {
+        memcpy(work.data(), source.data(), total * sizeof(int16_t));
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (size_t c = 0; c < CHUNKS; c++) scale(work.data() + c * CHUNK_SAMPLES, CHUNK_SAMPLES);
+        if (round > 0) elapsed += std::chrono::steady_clock::now() - start;  // Round 0 warms up
+    }
+    return elapsed.count() / (ROUNDS * total);
+}
+
+int main() {
+    const size_t total = CHUNK_SAMPLES * CHUNKS;
+    std::mt19937 rng(1);
+    std::vector<int16_t> source(total), expected(total), actual(total);
+    // Full scale, both rails included, so saturation is exercised.
+    for (size_t i = 0; i < total; i++) source[i] = (int16_t)(rng() & 0xFFFF);
+    source[0] = -32768;
+    source[1] = 32767;
+
+    printf("%zu chunks of %zu samples x %zu rounds\n\n", CHUNKS, CHUNK_SAMPLES, ROUNDS);
+    printf("%-8s %12s %12s %12s %8s\n", "volume", "float ns/s", "q15 ns/s", "ramp ns/s", "max err");
+
+    for (size_t l = 0; l < sizeof(LEVELS) / sizeof(LEVELS[0]); l++) {
+        float level = LEVELS[l];
+        int32_t gain = VolumeKernel::toQ15(level);
+
+        expected = source;
+        scaleFloat(expected.data(), total, level);
+        actual = source;
+        VolumeKernel::scale(actual.data(), total, gain);
+        int maxError = 0;
+        for (size_t i = 0; i < total; i++) {
+            int error = abs(expected[i] - actual[i]);
+            if (error > maxError) maxError = error;
+        }
+        if (maxError > 1) {
+            fprintf(stderr, "volume %.2f: Q15 differs from float by %d LSB\n", level, maxError);
+            return 1;
+        }
+
+        double floatNs = timeNsPerSample(source, actual, [&](int16_t* s, size_t n) { scaleFloat(s, n, level); });
+        double q15Ns = timeNsPerSample(source, actual, [&](int16_t* s, size_t n) { VolumeKernel::scale(s, n, gain); });
+        // Every chunk ramps from full volume: the cost paid while a change fades in.
+        double rampNs = timeNsPerSample(source, actual, [&](int16_t* s, size_t n) {
+            VolumeKernel::ramp(s, n, VolumeKernel::UNITY_Q15, gain, RAMP_STEP_Q15);
+        });
+        printf("%-8.2f %12.2f %12.2f %12.2f %8d\n", level, floatNs, q15Ns, rampNs, maxError);
+    }
+
+    // A ramp must step by no more than its step, and end on the target.
+    std::vector<int16_t> ones(4 * CHUNK_SAMPLES, 16384);
+    int32_t reached = VolumeKernel::ramp(ones.data(), ones.size(), VolumeKernel::UNITY_Q15, 0, RAMP_STEP_Q15);
+    for (size_t i = 1; i < ones.size(); i++) {
+        if (ones[i - 1] - ones[i] > RAMP_STEP_Q15 / 2 + 1) {
+            fprintf(stderr, "ramp jumps at sample %zu\n", i);
+            return 1;
+        }
+    }
+    if (reached != 0 || ones.back() != 0) {
+        fprintf(stderr, "ramp ended at gain %d, not 0\n", reached);
+        return 1;
+    }
+    return 0;
+}